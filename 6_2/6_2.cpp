@@ -1,9 +1,20 @@
+#include <algorithm>
 #include <chrono> // Для замера времени
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
 #include <iostream>
 #include <random> // Для генерации случайных строк
 #include <string>
 #include <vector>
 
+#include <fcntl.h> // Для отображения индекса в память (mmap)
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
 const int prime = 101; // Простое число для расчета хеша
 
 // Функция для вычисления хеш-значения строки
@@ -63,6 +74,223 @@ std::vector<int> rabinKarp(const std::string &text,
   return result;
 }
 
+// Суффиксный массив с массивом LCP для многократных запросов по одному тексту.
+// Индекс строится один раз, после чего count/locate работают за O(m log n)
+// без повторного просмотра всего текста.
+class SuffixIndex {
+private:
+  // Данные индекса либо лежат в собственных векторах (после build),
+  // либо указывают в отображённый в память файл (после load)
+  std::string ownText;
+  std::vector<int32_t> ownSa;
+  std::vector<int32_t> ownLcp;
+
+  const char *text = nullptr;
+  const int32_t *sa = nullptr;
+  const int32_t *lcp = nullptr;
+  int32_t n = 0;
+
+  void *mapped = nullptr;
+  size_t mappedSize = 0;
+
+  static constexpr char magic[8] = {'S', 'I', 'A', 'O', 'D', 'S', 'A', '1'};
+
+  // Сравнение образца с суффиксом, начинающимся в позиции pos:
+  // <0, если образец меньше, 0, если образец является префиксом суффикса
+  int comparePrefix(int32_t pos, const std::string &pattern) const {
+    int32_t len = std::min<int32_t>(pattern.size(), n - pos);
+    int cmp = std::memcmp(text + pos, pattern.data(), len);
+    if (cmp != 0)
+      return cmp < 0 ? 1 : -1;
+    return len < static_cast<int32_t>(pattern.size()) ? 1 : 0;
+  }
+
+  // Диапазон [first, last) суффиксов, начинающихся с образца
+  std::pair<int32_t, int32_t> equalRange(const std::string &pattern) const {
+    int32_t lo = 0, hi = n;
+    while (lo < hi) {
+      int32_t mid = lo + (hi - lo) / 2;
+      if (comparePrefix(sa[mid], pattern) > 0)
+        lo = mid + 1;
+      else
+        hi = mid;
+    }
+    int32_t first = lo;
+    hi = n;
+    while (lo < hi) {
+      int32_t mid = lo + (hi - lo) / 2;
+      if (comparePrefix(sa[mid], pattern) >= 0)
+        lo = mid + 1;
+      else
+        hi = mid;
+    }
+    return {first, lo};
+  }
+
+  void release() {
+    if (mapped) {
+      munmap(mapped, mappedSize);
+      mapped = nullptr;
+      mappedSize = 0;
+    }
+  }
+
+public:
+  SuffixIndex() = default;
+  SuffixIndex(const SuffixIndex &) = delete;
+  SuffixIndex &operator=(const SuffixIndex &) = delete;
+  ~SuffixIndex() { release(); }
+
+  // Построение суффиксного массива удвоением префиксов с поразрядной
+  // сортировкой (O(n log n)) и массива LCP алгоритмом Касаи (O(n))
+  void build(const std::string &str) {
+    release();
+    ownText = str;
+    n = static_cast<int32_t>(ownText.size());
+    ownSa.assign(n, 0);
+    ownLcp.assign(n, 0);
+
+    std::vector<int32_t> rank(n), tmp(n), buf(n);
+    std::vector<int32_t> cnt(std::max<int32_t>(n, 256) + 1);
+    for (int32_t i = 0; i < n; ++i) {
+      ownSa[i] = i;
+      rank[i] = static_cast<unsigned char>(ownText[i]);
+    }
+    std::sort(ownSa.begin(), ownSa.end(), [&](int32_t a, int32_t b) {
+      return rank[a] < rank[b];
+    });
+
+    for (int32_t k = 1; k < n; k <<= 1) {
+      // Ранг пары (rank[i], rank[i + k]); суффиксы короче k идут первыми
+      auto second = [&](int32_t i) { return i + k < n ? rank[i + k] + 1 : 0; };
+      int32_t classes = std::max<int32_t>(n, 256) + 1;
+
+      // Устойчивая сортировка подсчётом сначала по второму, затем по первому
+      // ключу
+      std::fill(cnt.begin(), cnt.begin() + classes, 0);
+      for (int32_t i = 0; i < n; ++i)
+        ++cnt[second(i)];
+      for (int32_t i = 1; i < classes; ++i)
+        cnt[i] += cnt[i - 1];
+      for (int32_t i = n - 1; i >= 0; --i)
+        buf[--cnt[second(i)]] = i;
+
+      std::fill(cnt.begin(), cnt.begin() + classes, 0);
+      for (int32_t i = 0; i < n; ++i)
+        ++cnt[rank[i]];
+      for (int32_t i = 1; i < classes; ++i)
+        cnt[i] += cnt[i - 1];
+      for (int32_t i = n - 1; i >= 0; --i)
+        ownSa[--cnt[rank[buf[i]]]] = buf[i];
+
+      tmp[ownSa[0]] = 0;
+      for (int32_t i = 1; i < n; ++i) {
+        int32_t a = ownSa[i - 1], b = ownSa[i];
+        tmp[b] = tmp[a] + (rank[a] != rank[b] || second(a) != second(b));
+      }
+      rank.swap(tmp);
+      if (rank[ownSa[n - 1]] == n - 1)
+        break; // Все суффиксы уже различимы
+    }
+
+    // LCP[i] — длина общего префикса суффиксов SA[i - 1] и SA[i]
+    for (int32_t i = 0; i < n; ++i)
+      rank[ownSa[i]] = i;
+    for (int32_t i = 0, h = 0; i < n; ++i) {
+      if (rank[i] == 0) {
+        h = 0;
+        continue;
+      }
+      int32_t j = ownSa[rank[i] - 1];
+      while (i + h < n && j + h < n && ownText[i + h] == ownText[j + h])
+        ++h;
+      ownLcp[rank[i]] = h;
+      if (h > 0)
+        --h;
+    }
+
+    text = ownText.data();
+    sa = ownSa.data();
+    lcp = ownLcp.data();
+  }
+
+  // Сохранение индекса: заголовок, длина, суффиксный массив, LCP и текст
+  bool save(const std::string &path) const {
+    std::ofstream out(path, std::ios::binary);
+    if (!out)
+      return false;
+    int64_t size = n;
+    out.write(magic, sizeof(magic));
+    out.write(reinterpret_cast<const char *>(&size), sizeof(size));
+    out.write(reinterpret_cast<const char *>(sa), n * sizeof(int32_t));
+    out.write(reinterpret_cast<const char *>(lcp), n * sizeof(int32_t));
+    out.write(text, n);
+    return static_cast<bool>(out);
+  }
+
+  // Загрузка индекса отображением файла в память без копирования
+  bool load(const std::string &path) {
+    release();
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+      return false;
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size < 16) {
+      close(fd);
+      return false;
+    }
+    void *addr = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (addr == MAP_FAILED)
+      return false;
+
+    const char *base = static_cast<const char *>(addr);
+    int64_t size;
+    std::memcpy(&size, base + 8, sizeof(size));
+    if (std::memcmp(base, magic, sizeof(magic)) != 0 ||
+        static_cast<int64_t>(st.st_size) != 16 + size * 9) {
+      munmap(addr, st.st_size);
+      return false;
+    }
+
+    mapped = addr;
+    mappedSize = st.st_size;
+    n = static_cast<int32_t>(size);
+    sa = reinterpret_cast<const int32_t *>(base + 16);
+    lcp = sa + n;
+    text = base + 16 + n * 8;
+    ownText.clear();
+    ownSa.clear();
+    ownLcp.clear();
+    return true;
+  }
+
+  // Количество вхождений образца
+  int count(const std::string &pattern) const {
+    if (pattern.empty())
+      return n;
+    std::pair<int32_t, int32_t> range = equalRange(pattern);
+    return range.second - range.first;
+  }
+
+  // Позиции вхождений образца в порядке возрастания
+  std::vector<int> locate(const std::string &pattern) const {
+    std::vector<int> result;
+    if (pattern.empty())
+      return result;
+    std::pair<int32_t, int32_t> range = equalRange(pattern);
+    result.assign(sa + range.first, sa + range.second);
+    std::sort(result.begin(), result.end());
+    return result;
+  }
+
+  int size() const { return n; }
+  const int32_t *suffixArray() const { return sa; }
+  const int32_t *lcpArray() const { return lcp; }
+};
+
+constexpr char SuffixIndex::magic[8];
+
 // Функция для генерации случайной строки заданной длины
 std::string generateRandomString(int length) {
   std::string chars = "abcde";
@@ -102,11 +330,68 @@ void test(int textLength, int patternLength) {
     std::cout << "------------------------" << std::endl;
 }
 
+
+// Сравнение задержки одного запроса: повторный просмотр текста Рабином-Карпом
+// против поиска по заранее построенному и загруженному через mmap индексу
+void benchmarkIndex(int textLength, int patternLength, int queries) {
+  std::string text = generateRandomString(textLength);
+  std::vector<std::string> patterns;
+  for (int q = 0; q < queries; ++q)
+    patterns.push_back(generateRandomString(patternLength));
+
+  auto start = std::chrono::high_resolution_clock::now();
+  SuffixIndex built;
+  built.build(text);
+  auto end = std::chrono::high_resolution_clock::now();
+  std::chrono::duration<double> buildTime = end - start;
+
+  const std::string path = "suffix_index.bin";
+  SuffixIndex index;
+  if (!built.save(path) || !index.load(path)) {
+    std::cout << "Не удалось сохранить или загрузить индекс" << std::endl;
+    return;
+  }
+
+  start = std::chrono::high_resolution_clock::now();
+  size_t scanned = 0;
+  for (const auto &pattern : patterns)
+    scanned += rabinKarp(text, pattern).size();
+  end = std::chrono::high_resolution_clock::now();
+  std::chrono::duration<double> scanTime = end - start;
+
+  start = std::chrono::high_resolution_clock::now();
+  size_t located = 0;
+  for (const auto &pattern : patterns)
+    located += index.locate(pattern).size();
+  end = std::chrono::high_resolution_clock::now();
+  std::chrono::duration<double> indexTime = end - start;
+
+  bool same = true;
+  for (int q = 0; q < std::min(queries, 10); ++q)
+    same = same && rabinKarp(text, patterns[q]) == index.locate(patterns[q]);
+  std::remove(path.c_str());
+
+  std::cout << "Индекс для текста длины " << textLength << ", образцы длины "
+            << patternLength << ", запросов " << queries << std::endl;
+  std::cout << "Построение индекса: " << buildTime.count() * 1000
+            << " миллисекунд" << std::endl;
+  std::cout << "Рабин-Карп на запрос: " << scanTime.count() * 1e6 / queries
+            << " микросекунд" << std::endl;
+  std::cout << "Индекс на запрос: " << indexTime.count() * 1e6 / queries
+            << " микросекунд" << std::endl;
+  std::cout << "Совпадение результатов: "
+            << (same && scanned == located ? "успех" : "ошибка") << std::endl;
+  std::cout << "------------------------" << std::endl;
+}
+
 int main() {
     test(100, 2);
     test(1000, 2);
     test(10000, 2);
     test(100000, 2);
 
+    benchmarkIndex(100000, 4, 1000);
+    benchmarkIndex(1000000, 6, 200);
+
     return 0;
 }
@@ -1,156 +1,1223 @@
 #include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <climits>
+#include <cstdint>
+#include <deque>
 #include <iostream>
+#include <iterator>
+#include <memory>
+#include <random>
+#include <thread>
+#include <vector>
 
-// Структура узла дерева
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#endif
+
+// Индекс узла в пуле; нулевой элемент пула — пустой узел-страж
+const uint32_t NIL = 0;
+
+// Структура узла дерева: потомки хранятся 32-битными индексами в пуле.
+// Узел хранит агрегаты своего поддерева: число узлов, сумму ключей и сумму
+// ключей листьев
 struct Node {
   int key;
-  Node *left;
-  Node *right;
+  uint32_t left;
+  uint32_t right;
   int height;
+  uint32_t size;
+  long long sum;
+  long long leafSum;
+};
+
+// Пул узлов: все узлы лежат в одном непрерывном векторе, освобождённые
+// узлы связываются в список свободных через поле left
+class NodePool {
+private:
+  std::vector<Node> nodes;
+  uint32_t freeHead = NIL;
+
+public:
+  NodePool() { nodes.push_back({0, NIL, NIL, 0, 0, 0, 0}); }
+
+  uint32_t allocate(int key) {
+    if (freeHead != NIL) {
+      uint32_t index = freeHead;
+      freeHead = nodes[index].left;
+      nodes[index] = {key, NIL, NIL, 1, 1, key, key};
+      return index;
+    }
+    nodes.push_back({key, NIL, NIL, 1, 1, key, key});
+    return static_cast<uint32_t>(nodes.size() - 1);
+  }
+
+  void release(uint32_t index) {
+    nodes[index].left = freeHead;
+    freeHead = index;
+  }
+
+  // Освобождение всех узлов разом, без обхода дерева
+  void clear() {
+    nodes.resize(1);
+    freeHead = NIL;
+  }
+
+  void reserve(size_t count) { nodes.reserve(count + 1); }
+
+  // Выделение непрерывного блока из count узлов в конце пула
+  uint32_t allocateBlock(size_t count) {
+    uint32_t first = static_cast<uint32_t>(nodes.size());
+    nodes.resize(nodes.size() + count);
+    return first;
+  }
 
-  explicit Node(int k) : key(k), left(nullptr), right(nullptr), height(1) {}
+  Node &operator[](uint32_t index) { return nodes[index]; }
+  const Node &operator[](uint32_t index) const { return nodes[index]; }
 };
 
-// Функция для получения высоты узла
-int height(const Node *node) { return node ? node->height : 0; }
+// Максимальная глубина пути: высота АВЛ-дерева не превышает 1.44·log2(n)
+const int MAX_DEPTH = 64;
 
-// Функция для вычисления баланса узла
-int getBalance(const Node *node) {
-  return node ? height(node->left) - height(node->right) : 0;
-}
+// АВЛ-дерево с итеративными вставкой, удалением и обходами. Несколько
+// деревьев могут делить один пул узлов; join и split работают за O(log n)
+// без копирования узлов только внутри одного пула
+class AVLTree {
+private:
+  std::shared_ptr<NodePool> storage;
+  NodePool &pool;
+  uint32_t root = NIL;
 
-// Поворот вправо
-Node *rotateRight(Node *y) {
-  Node *x = y->left;
-  Node *T2 = x->right;
+  // Функция для получения высоты узла (у стража высота 0)
+  int height(uint32_t node) const { return pool[node].height; }
 
-  // Выполнение поворота
-  x->right = y;
-  y->left = T2;
+  // Функция для вычисления баланса узла
+  int getBalance(uint32_t node) const {
+    return height(pool[node].left) - height(pool[node].right);
+  }
 
-  // Обновление высот
-  y->height = std::max(height(y->left), height(y->right)) + 1;
-  x->height = std::max(height(x->left), height(x->right)) + 1;
+  // Пересчёт высоты и агрегатов узла по его потомкам
+  void update(uint32_t node) {
+    Node &n = pool[node];
+    const Node &l = pool[n.left];
+    const Node &r = pool[n.right];
+    n.height = 1 + std::max(l.height, r.height);
+    n.size = 1 + l.size + r.size;
+    n.sum = n.key + l.sum + r.sum;
+    n.leafSum = (n.left || n.right) ? l.leafSum + r.leafSum : n.key;
+  }
 
-  return x;
-}
+  // Поворот вправо
+  uint32_t rotateRight(uint32_t y) {
+    uint32_t x = pool[y].left;
+    uint32_t T2 = pool[x].right;
 
-// Поворот влево
-Node *rotateLeft(Node *x) {
-  Node *y = x->right;
-  Node *T2 = y->left;
+    // Выполнение поворота
+    pool[x].right = y;
+    pool[y].left = T2;
 
-  // Выполнение поворота
-  y->left = x;
-  x->right = T2;
+    // Обновление высот и агрегатов
+    update(y);
+    update(x);
 
-  // Обновление высот
-  x->height = std::max(height(x->left), height(x->right)) + 1;
-  y->height = std::max(height(y->left), height(y->right)) + 1;
+    return x;
+  }
 
-  return y;
-}
+  // Поворот влево
+  uint32_t rotateLeft(uint32_t x) {
+    uint32_t y = pool[x].right;
+    uint32_t T2 = pool[y].left;
 
-// Вставка элемента в АВЛ-дерево с балансировкой
-Node *insert(Node *node, int key) {
-  if (!node)
-    return new Node(key);
+    // Выполнение поворота
+    pool[y].left = x;
+    pool[x].right = T2;
 
-  if (key < node->key) {
-    node->left = insert(node->left, key);
-  } else if (key > node->key) {
-    node->right = insert(node->right, key);
-  } else {
-    return node; // Дубликаты не допускаются
+    // Обновление высот и агрегатов
+    update(x);
+    update(y);
+
+    return y;
   }
 
-  node->height = 1 + std::max(height(node->left), height(node->right));
+  // Восстановление баланса узла, возвращает новый корень поддерева
+  uint32_t rebalance(uint32_t node) {
+    update(node);
+    int balance = getBalance(node);
+
+    // Левый Левый и Левый Правый случаи
+    if (balance > 1) {
+      if (getBalance(pool[node].left) < 0)
+        pool[node].left = rotateLeft(pool[node].left);
+      return rotateRight(node);
+    }
 
-  int balance = getBalance(node);
+    // Правый Правый и Правый Левый случаи
+    if (balance < -1) {
+      if (getBalance(pool[node].right) > 0)
+        pool[node].right = rotateRight(pool[node].right);
+      return rotateLeft(node);
+    }
 
-  // Левый Левый случай
-  if (balance > 1 && key < node->left->key) {
-    return rotateRight(node);
+    return node;
   }
 
-  // Правый Правый случай
-  if (balance < -1 && key > node->right->key) {
-    return rotateLeft(node);
+  // Замена потомка old у родителя на replacement
+  void replaceChild(uint32_t parent, uint32_t old, uint32_t replacement) {
+    if (pool[parent].left == old)
+      pool[parent].left = replacement;
+    else
+      pool[parent].right = replacement;
   }
 
-  // Левый Правый случай
-  if (balance > 1 && key > node->left->key) {
-    node->left = rotateLeft(node->left);
-    return rotateRight(node);
+  // Подъём по сохранённому пути с перебалансировкой. Как только высота
+  // очередного поддерева не изменилась, балансировка выше не нужна, и
+  // оставшиеся предки только пересчитывают агрегаты.
+  // Возвращает новый корень поддерева path[0]
+  uint32_t fixPath(const uint32_t *path, int depth) {
+    int i = depth - 1;
+    for (; i >= 0; --i) {
+      uint32_t node = path[i];
+      int oldHeight = pool[node].height;
+      uint32_t subtree = rebalance(node);
+      if (i == 0)
+        return subtree;
+      if (subtree != node)
+        replaceChild(path[i - 1], node, subtree);
+      if (pool[subtree].height == oldHeight)
+        break;
+    }
+    for (--i; i >= 0; --i)
+      update(path[i]);
+    return depth > 0 ? path[0] : NIL;
   }
 
-  // Правый Левый случай
-  if (balance < -1 && key < node->right->key) {
-    node->right = rotateRight(node->right);
-    return rotateLeft(node);
+  // Сумма ключей, меньших key (или не больших при inclusive)
+  long long prefixSum(int key, bool inclusive) const {
+    long long sum = 0;
+    uint32_t node = root;
+    while (node) {
+      const Node &n = pool[node];
+      if (n.key < key || (inclusive && n.key == key)) {
+        sum += pool[n.left].sum + n.key;
+        node = n.right;
+      } else {
+        node = n.left;
+      }
+    }
+    return sum;
   }
 
-  return node;
-}
+  // Сбалансированное поддерево из узлов first + [lo, hi), уже лежащих в пуле
+  // в порядке возрастания ключей
+  uint32_t buildRange(uint32_t first, uint32_t lo, uint32_t hi) {
+    if (lo >= hi)
+      return NIL;
+    uint32_t mid = lo + (hi - lo) / 2;
+    uint32_t node = first + mid;
+    pool[node].left = buildRange(first, lo, mid);
+    pool[node].right = buildRange(first, mid + 1, hi);
+    update(node);
+    return node;
+  }
+
+  // Соединение left < mid < right в одно дерево за O(|h(left) - h(right)| + 1):
+  // узел mid подвешивается на спуске по краю более высокого дерева
+  uint32_t joinNodes(uint32_t left, uint32_t mid, uint32_t right) {
+    int leftHeight = height(left), rightHeight = height(right);
+    uint32_t path[MAX_DEPTH];
+    int depth = 0;
+    if (leftHeight > rightHeight + 1) {
+      uint32_t node = left;
+      while (height(node) > rightHeight + 1) {
+        path[depth++] = node;
+        node = pool[node].right;
+      }
+      left = node;
+    } else if (rightHeight > leftHeight + 1) {
+      uint32_t node = right;
+      while (height(node) > leftHeight + 1) {
+        path[depth++] = node;
+        node = pool[node].left;
+      }
+      right = node;
+    }
+
+    pool[mid].left = left;
+    pool[mid].right = right;
+    update(mid);
+    if (depth == 0)
+      return mid;
 
-// Симметричный обход (in-order)
-void inOrder(Node *root) {
-  if (root) {
-    inOrder(root->left);
-    std::cout << root->key << " ";
-    inOrder(root->right);
+    uint32_t parent = path[depth - 1];
+    if (leftHeight > rightHeight)
+      pool[parent].right = mid;
+    else
+      pool[parent].left = mid;
+    return fixPath(path, depth);
   }
-}
 
-// Обратный обход (post-order)
-void postOrder(Node *root) {
-  if (root) {
-    postOrder(root->left);
-    postOrder(root->right);
-    std::cout << root->key << " ";
+  // Отсоединение минимального узла поддерева; subroot обновляется
+  uint32_t detachMin(uint32_t &subroot) {
+    uint32_t path[MAX_DEPTH];
+    int depth = 0;
+    uint32_t node = subroot;
+    while (pool[node].left) {
+      path[depth++] = node;
+      node = pool[node].left;
+    }
+    if (depth == 0) {
+      subroot = pool[node].right;
+    } else {
+      pool[path[depth - 1]].left = pool[node].right;
+      subroot = fixPath(path, depth);
+    }
+    return node;
+  }
+
+  // Возврат всех узлов поддерева в список свободных
+  void releaseSubtree(uint32_t node) {
+    std::vector<uint32_t> stack;
+    if (node)
+      stack.push_back(node);
+    while (!stack.empty()) {
+      uint32_t current = stack.back();
+      stack.pop_back();
+      if (pool[current].left)
+        stack.push_back(pool[current].left);
+      if (pool[current].right)
+        stack.push_back(pool[current].right);
+      pool.release(current);
+    }
+  }
+
+  // Обратный проход по правой цепочке from -> to (через разворот указателей)
+  template <typename F> void visitReversed(uint32_t from, uint32_t to, F &visit) {
+    uint32_t prev = NIL, node = from;
+    while (true) {
+      uint32_t next = pool[node].right;
+      pool[node].right = prev;
+      if (node == to)
+        break;
+      prev = node;
+      node = next;
+    }
+    node = to;
+    prev = NIL;
+    while (true) {
+      visit(pool[node].key);
+      uint32_t next = pool[node].right;
+      pool[node].right = prev;
+      if (node == from)
+        break;
+      prev = node;
+      node = next;
+    }
+  }
+
+public:
+  AVLTree() : storage(std::make_shared<NodePool>()), pool(*storage) {}
+
+  // Пустое дерево, узлы которого будут выделяться в общем пуле
+  explicit AVLTree(std::shared_ptr<NodePool> shared)
+      : storage(std::move(shared)), pool(*storage) {}
+
+  AVLTree(AVLTree &&other) noexcept
+      : storage(other.storage), pool(*storage), root(other.root) {
+    other.root = NIL;
+  }
+
+  AVLTree(const AVLTree &) = delete;
+  AVLTree &operator=(const AVLTree &) = delete;
+
+  ~AVLTree() {
+    if (storage.use_count() > 1)
+      releaseSubtree(root);
   }
+
+  // Вставка элемента; возвращает false для дубликата
+  bool insert(int key) {
+    uint32_t path[MAX_DEPTH];
+    int depth = 0;
+    uint32_t node = root;
+    while (node) {
+      path[depth++] = node;
+      if (key < pool[node].key)
+        node = pool[node].left;
+      else if (key > pool[node].key)
+        node = pool[node].right;
+      else
+        return false; // Дубликаты не допускаются
+    }
+
+    uint32_t fresh = pool.allocate(key);
+    if (depth == 0) {
+      root = fresh;
+      return true;
+    }
+    uint32_t parent = path[depth - 1];
+    if (key < pool[parent].key)
+      pool[parent].left = fresh;
+    else
+      pool[parent].right = fresh;
+
+    root = fixPath(path, depth);
+    return true;
+  }
+
+  // Удаление элемента; возвращает false, если ключ не найден
+  bool erase(int key) {
+    uint32_t path[MAX_DEPTH];
+    int depth = 0;
+    uint32_t node = root;
+    while (node && pool[node].key != key) {
+      path[depth++] = node;
+      node = key < pool[node].key ? pool[node].left : pool[node].right;
+    }
+    if (!node)
+      return false;
+
+    // У узла с двумя потомками ключ заменяется преемником,
+    // а удаляется сам преемник
+    if (pool[node].left && pool[node].right) {
+      path[depth++] = node;
+      uint32_t successor = pool[node].right;
+      while (pool[successor].left) {
+        path[depth++] = successor;
+        successor = pool[successor].left;
+      }
+      pool[node].key = pool[successor].key;
+      node = successor;
+    }
+
+    uint32_t child = pool[node].left ? pool[node].left : pool[node].right;
+    pool.release(node);
+    if (depth == 0) {
+      root = child;
+      return true;
+    }
+    replaceChild(path[depth - 1], node, child);
+
+    root = fixPath(path, depth);
+    return true;
+  }
+
+  // Поиск ключа в дереве
+  bool find(int key) const {
+    uint32_t node = root;
+    while (node) {
+      if (key < pool[node].key)
+        node = pool[node].left;
+      else if (key > pool[node].key)
+        node = pool[node].right;
+      else
+        return true;
+    }
+    return false;
+  }
+
+  // Построение идеально сбалансированного дерева из строго возрастающей
+  // последовательности за O(n): узлы выделяются одним блоком, высоты
+  // вычисляются снизу вверх. Неупорядоченный вход вставляется поштучно
+  template <typename RandomIt> void buildFromSorted(RandomIt begin, RandomIt end) {
+    clear();
+    bool strictlySorted =
+        std::adjacent_find(begin, end, [](int a, int b) { return a >= b; }) == end;
+    if (!strictlySorted) {
+      for (RandomIt it = begin; it != end; ++it)
+        insert(*it);
+      return;
+    }
+    uint32_t count = static_cast<uint32_t>(std::distance(begin, end));
+    uint32_t first = pool.allocateBlock(count);
+    for (uint32_t i = 0; i < count; ++i)
+      pool[first + i].key = begin[i];
+    root = buildRange(first, 0, count);
+  }
+
+  // Присоединение дерева other, все ключи которого больше ключей этого
+  // дерева. За O(log n) — только если other живёт в том же пуле; дерево
+  // из другого пула перестраивается в нашем за O(m), так что деревья для
+  // последующего join нужно строить в общем пуле. Возвращает false, если
+  // диапазоны ключей пересекаются
+  bool join(AVLTree &other) {
+    if (!other.root)
+      return true;
+    if (root) {
+      uint32_t maxNode = root, minNode = other.root;
+      while (pool[maxNode].right)
+        maxNode = pool[maxNode].right;
+      while (other.pool[minNode].left)
+        minNode = other.pool[minNode].left;
+      if (pool[maxNode].key >= other.pool[minNode].key)
+        return false;
+    }
+
+    uint32_t right;
+    if (other.storage == storage) {
+      right = other.root;
+      other.root = NIL;
+    } else {
+      std::vector<int> keys;
+      other.forEachInOrder([&keys](int key) { keys.push_back(key); });
+      other.clear();
+      uint32_t first = pool.allocateBlock(keys.size());
+      for (uint32_t i = 0; i < keys.size(); ++i)
+        pool[first + i].key = keys[i];
+      right = buildRange(first, 0, static_cast<uint32_t>(keys.size()));
+    }
+
+    uint32_t mid = detachMin(right);
+    root = joinNodes(root, mid, right);
+    return true;
+  }
+
+  // Разрезание по ключу за O(log n): в дереве остаются ключи меньше key,
+  // остальные возвращаются отдельным деревом в том же пуле
+  AVLTree split(int key) {
+    uint32_t path[MAX_DEPTH];
+    int depth = 0;
+    uint32_t node = root;
+    while (node && pool[node].key != key) {
+      path[depth++] = node;
+      node = key < pool[node].key ? pool[node].left : pool[node].right;
+    }
+
+    uint32_t left = NIL, right = NIL;
+    if (node) {
+      left = pool[node].left;
+      right = joinNodes(NIL, node, pool[node].right);
+    }
+    for (int i = depth - 1; i >= 0; --i) {
+      node = path[i];
+      uint32_t nodeLeft = pool[node].left, nodeRight = pool[node].right;
+      if (key < pool[node].key)
+        right = joinNodes(right, node, nodeRight);
+      else
+        left = joinNodes(nodeLeft, node, left);
+    }
+
+    root = left;
+    AVLTree result(storage);
+    result.root = right;
+    return result;
+  }
+
+  // Симметричный обход Морриса: без стека, временные ссылки на преемника
+  // ставятся в пустые правые указатели и снимаются при возврате
+  template <typename F> void forEachInOrder(F visit) {
+    uint32_t node = root;
+    while (node) {
+      if (!pool[node].left) {
+        visit(pool[node].key);
+        node = pool[node].right;
+        continue;
+      }
+      uint32_t pred = pool[node].left;
+      while (pool[pred].right && pool[pred].right != node)
+        pred = pool[pred].right;
+      if (!pool[pred].right) {
+        pool[pred].right = node;
+        node = pool[node].left;
+      } else {
+        pool[pred].right = NIL;
+        visit(pool[node].key);
+        node = pool[node].right;
+      }
+    }
+  }
+
+  // Обратный обход Морриса через фиктивный узел, левым потомком которого
+  // является корень
+  template <typename F> void forEachPostOrder(F visit) {
+    if (!root)
+      return;
+    uint32_t dummy = pool.allocate(0);
+    pool[dummy].left = root;
+    uint32_t node = dummy;
+    while (node) {
+      if (!pool[node].left) {
+        node = pool[node].right;
+        continue;
+      }
+      uint32_t pred = pool[node].left;
+      while (pool[pred].right && pool[pred].right != node)
+        pred = pool[pred].right;
+      if (!pool[pred].right) {
+        pool[pred].right = node;
+        node = pool[node].left;
+      } else {
+        pool[pred].right = NIL;
+        visitReversed(pool[node].left, pred, visit);
+        node = pool[node].right;
+      }
+    }
+    pool.release(dummy);
+  }
+
+  // Симметричный обход (in-order)
+  void inOrder() {
+    forEachInOrder([](int key) { std::cout << key << " "; });
+  }
+
+  // Обратный обход (post-order)
+  void postOrder() {
+    forEachPostOrder([](int key) { std::cout << key << " "; });
+  }
+
+  // Нахождение суммы значений листьев: хранится в корне, O(1)
+  long long sumOfLeaves() const { return pool[root].leafSum; }
+
+  // Количество элементов в дереве
+  uint32_t size() const { return pool[root].size; }
+
+  // k-й по возрастанию ключ (k от 1 до size()); false, если k вне диапазона
+  bool kth(uint32_t k, int &key) const {
+    if (k < 1 || k > size())
+      return false;
+    uint32_t node = root;
+    while (true) {
+      uint32_t leftSize = pool[pool[node].left].size;
+      if (k <= leftSize) {
+        node = pool[node].left;
+      } else if (k == leftSize + 1) {
+        key = pool[node].key;
+        return true;
+      } else {
+        k -= leftSize + 1;
+        node = pool[node].right;
+      }
+    }
+  }
+
+  // Количество ключей, меньших key
+  uint32_t rank(int key) const {
+    uint32_t result = 0;
+    uint32_t node = root;
+    while (node) {
+      if (pool[node].key < key) {
+        result += pool[pool[node].left].size + 1;
+        node = pool[node].right;
+      } else {
+        node = pool[node].left;
+      }
+    }
+    return result;
+  }
+
+  // Сумма ключей из отрезка [lo, hi] за O(log n)
+  long long rangeSum(int lo, int hi) const {
+    if (lo > hi)
+      return 0;
+    return prefixSum(hi, true) - prefixSum(lo, false);
+  }
+
+  // Нахождение высоты дерева
+  int treeHeight() const { return height(root); }
+
+  // Печать дерева, повёрнутого на 90 градусов: обратный симметричный обход
+  // с явным стеком пар (узел, отступ)
+  void printTree(int height = 10) const {
+    std::pair<uint32_t, int> stack[MAX_DEPTH];
+    int top = 0;
+    uint32_t node = root;
+    int space = height;
+    while (node || top > 0) {
+      while (node) {
+        stack[top++] = {node, space};
+        node = pool[node].right;
+        space += height;
+      }
+      std::pair<uint32_t, int> current = stack[--top];
+      std::cout << std::endl;
+      for (int i = height; i < current.second; i++)
+        std::cout << " ";
+      std::cout << pool[current.first].key << "\n";
+      node = pool[current.first].left;
+      space = current.second + height;
+    }
+  }
+
+  // Освобождение всех узлов разом; если пул общий с другими деревьями,
+  // узлы этого дерева возвращаются в список свободных по одному
+  void clear() {
+    if (storage.use_count() > 1)
+      releaseSubtree(root);
+    else
+      pool.clear();
+    root = NIL;
+  }
+};
+
+// Ёмкости узлов B+-дерева: и лист, и внутренний узел занимают около
+// 256 байт (четыре строки кэша), число ключей кратно ширине SIMD-регистра
+const uint32_t LEAF_KEYS = 64;
+const uint32_t INNER_KEYS = 32;
+
+// Лист B+-дерева: ключи по возрастанию, свободные ячейки заполнены INT_MAX,
+// листья связаны в список для последовательного обхода
+struct BPlusLeaf {
+  int keys[LEAF_KEYS];
+  uint32_t count;
+  uint32_t next;
+};
+
+// Внутренний узел: в children[i] лежат ключи из [keys[i - 1], keys[i])
+struct BPlusInner {
+  int keys[INNER_KEYS];
+  uint32_t children[INNER_KEYS + 1];
+  uint32_t count;
+};
+
+// Количество ключей меньше x среди первых count ключей узла. Сравниваются
+// целые блоки по 4 ключа: заполнитель INT_MAX никогда не меньше x
+inline uint32_t countLess(const int *keys, uint32_t count, int x) {
+  uint32_t result = 0;
+#if defined(__SSE2__)
+  __m128i needle = _mm_set1_epi32(x);
+  for (uint32_t i = 0; i < count; i += 4) {
+    __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i *>(keys + i));
+    int mask = _mm_movemask_ps(_mm_castsi128_ps(_mm_cmplt_epi32(block, needle)));
+    result += __builtin_popcount(mask);
+  }
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+  int32x4_t needle = vdupq_n_s32(x);
+  for (uint32_t i = 0; i < count; i += 4) {
+    uint32x4_t less = vcltq_s32(vld1q_s32(keys + i), needle);
+    result += vaddvq_u32(vshrq_n_u32(less, 31));
+  }
+#else
+  for (uint32_t i = 0; i < count; ++i)
+    result += keys[i] < x;
+#endif
+  return result;
 }
 
-// Нахождение суммы значений листьев
-int sumOfLeaves(Node *root) {
-  if (!root)
-    return 0;
+// Количество ключей не больше x
+inline uint32_t countLessEqual(const int *keys, uint32_t count, int x) {
+  return x == INT_MAX ? count : countLess(keys, count, x + 1);
+}
+
+// B+-дерево множества целых ключей с тем же интерфейсом, что у AVLTree:
+// узлы в двух непрерывных пулах, связь по 32-битным индексам, все ключи
+// хранятся в листьях
+class BPlusTree {
+private:
+  std::vector<BPlusLeaf> leaves;
+  std::vector<BPlusInner> inners;
+  uint32_t root = 0;   // Индекс корня в пуле своего уровня
+  int levels = 1;      // Число уровней; при levels == 1 корень — лист
+  uint32_t firstLeaf = 0;
+  size_t keyCount = 0;
+
+  uint32_t newLeaf() {
+    BPlusLeaf leaf;
+    std::fill(leaf.keys, leaf.keys + LEAF_KEYS, INT_MAX);
+    leaf.count = 0;
+    leaf.next = UINT32_MAX;
+    leaves.push_back(leaf);
+    return static_cast<uint32_t>(leaves.size() - 1);
+  }
+
+  uint32_t newInner() {
+    BPlusInner inner;
+    std::fill(inner.keys, inner.keys + INNER_KEYS, INT_MAX);
+    inner.count = 0;
+    inners.push_back(inner);
+    return static_cast<uint32_t>(inners.size() - 1);
+  }
 
-  if (!root->left && !root->right) {
-    return root->key;
+  // Вставка разделителя separator и правого потомка right в узел на позицию
+  // pos; при переполнении узел делится, в separator/right возвращается то,
+  // что нужно вставить уровнем выше. Возвращает true, если было деление
+  bool insertIntoInner(uint32_t node, uint32_t pos, int &separator,
+                       uint32_t &right) {
+    BPlusInner &inner = inners[node];
+    if (inner.count < INNER_KEYS) {
+      std::copy_backward(inner.keys + pos, inner.keys + inner.count,
+                         inner.keys + inner.count + 1);
+      std::copy_backward(inner.children + pos + 1,
+                         inner.children + inner.count + 1,
+                         inner.children + inner.count + 2);
+      inner.keys[pos] = separator;
+      inner.children[pos + 1] = right;
+      ++inner.count;
+      return false;
+    }
+
+    int keys[INNER_KEYS + 1];
+    uint32_t children[INNER_KEYS + 2];
+    std::copy(inner.keys, inner.keys + pos, keys);
+    keys[pos] = separator;
+    std::copy(inner.keys + pos, inner.keys + INNER_KEYS, keys + pos + 1);
+    std::copy(inner.children, inner.children + pos + 1, children);
+    children[pos + 1] = right;
+    std::copy(inner.children + pos + 1, inner.children + INNER_KEYS + 1,
+              children + pos + 2);
+
+    const uint32_t half = INNER_KEYS / 2;
+    uint32_t sibling = newInner();
+    BPlusInner &left = inners[node];
+    BPlusInner &fresh = inners[sibling];
+    std::fill(left.keys, left.keys + INNER_KEYS, INT_MAX);
+    std::copy(keys, keys + half, left.keys);
+    std::copy(children, children + half + 1, left.children);
+    left.count = half;
+    std::copy(keys + half + 1, keys + INNER_KEYS + 1, fresh.keys);
+    std::copy(children + half + 1, children + INNER_KEYS + 2, fresh.children);
+    fresh.count = INNER_KEYS - half;
+
+    separator = keys[half];
+    right = sibling;
+    return true;
   }
 
-  return sumOfLeaves(root->left) + sumOfLeaves(root->right);
+public:
+  BPlusTree() { clear(); }
+
+  // Вставка элемента; возвращает false для дубликата
+  bool insert(int key) {
+    uint32_t path[MAX_DEPTH];
+    uint32_t slots[MAX_DEPTH];
+    uint32_t node = root;
+    for (int level = 0; level < levels - 1; ++level) {
+      const BPlusInner &inner = inners[node];
+      path[level] = node;
+      slots[level] = countLessEqual(inner.keys, inner.count, key);
+      node = inner.children[slots[level]];
+    }
+
+    BPlusLeaf &leaf = leaves[node];
+    uint32_t pos = countLess(leaf.keys, leaf.count, key);
+    if (pos < leaf.count && leaf.keys[pos] == key)
+      return false; // Дубликаты не допускаются
+    ++keyCount;
+
+    if (leaf.count < LEAF_KEYS) {
+      std::copy_backward(leaf.keys + pos, leaf.keys + leaf.count,
+                         leaf.keys + leaf.count + 1);
+      leaf.keys[pos] = key;
+      ++leaf.count;
+      return true;
+    }
+
+    // Деление переполненного листа пополам
+    const uint32_t half = LEAF_KEYS / 2;
+    uint32_t sibling = newLeaf();
+    BPlusLeaf &left = leaves[node];
+    BPlusLeaf &fresh = leaves[sibling];
+    std::copy(left.keys + half, left.keys + LEAF_KEYS, fresh.keys);
+    std::fill(left.keys + half, left.keys + LEAF_KEYS, INT_MAX);
+    left.count = half;
+    fresh.count = LEAF_KEYS - half;
+    fresh.next = left.next;
+    left.next = sibling;
+
+    BPlusLeaf &target = pos <= half ? left : fresh;
+    uint32_t targetPos = pos <= half ? pos : pos - half;
+    std::copy_backward(target.keys + targetPos, target.keys + target.count,
+                       target.keys + target.count + 1);
+    target.keys[targetPos] = key;
+    ++target.count;
+
+    // Подъём разделителей по пути, пока узлы делятся
+    int separator = fresh.keys[0];
+    uint32_t right = sibling;
+    for (int level = levels - 2; level >= 0; --level) {
+      if (!insertIntoInner(path[level], slots[level], separator, right))
+        return true;
+    }
+
+    uint32_t newRoot = newInner();
+    inners[newRoot].keys[0] = separator;
+    inners[newRoot].children[0] = root;
+    inners[newRoot].children[1] = right;
+    inners[newRoot].count = 1;
+    root = newRoot;
+    ++levels;
+    return true;
+  }
+
+  // Поиск ключа в дереве
+  bool find(int key) const {
+    uint32_t node = root;
+    for (int level = 0; level < levels - 1; ++level) {
+      const BPlusInner &inner = inners[node];
+      node = inner.children[countLessEqual(inner.keys, inner.count, key)];
+    }
+    const BPlusLeaf &leaf = leaves[node];
+    uint32_t pos = countLess(leaf.keys, leaf.count, key);
+    return pos < leaf.count && leaf.keys[pos] == key;
+  }
+
+  // Симметричный обход: последовательный проход по списку листьев
+  template <typename F> void forEachInOrder(F visit) const {
+    for (uint32_t leaf = firstLeaf; leaf != UINT32_MAX; leaf = leaves[leaf].next) {
+      const BPlusLeaf &current = leaves[leaf];
+      for (uint32_t i = 0; i < current.count; ++i)
+        visit(current.keys[i]);
+    }
+  }
+
+  // Обратный обход: сначала все потомки узла, затем его ключи (для
+  // внутренних узлов — разделители). Явный стек пар (узел, уровень)
+  template <typename F> void forEachPostOrder(F visit) const {
+    if (keyCount == 0)
+      return;
+    struct Frame {
+      uint32_t node;
+      int level;
+      uint32_t child;
+    };
+    Frame stack[MAX_DEPTH];
+    int top = 0;
+    stack[top++] = {root, 0, 0};
+    while (top > 0) {
+      Frame &frame = stack[top - 1];
+      if (frame.level == levels - 1) {
+        const BPlusLeaf &leaf = leaves[frame.node];
+        for (uint32_t i = 0; i < leaf.count; ++i)
+          visit(leaf.keys[i]);
+        --top;
+        continue;
+      }
+      const BPlusInner &inner = inners[frame.node];
+      if (frame.child <= inner.count) {
+        uint32_t child = inner.children[frame.child++];
+        stack[top++] = {child, frame.level + 1, 0};
+        continue;
+      }
+      for (uint32_t i = 0; i < inner.count; ++i)
+        visit(inner.keys[i]);
+      --top;
+    }
+  }
+
+  // Симметричный обход (in-order)
+  void inOrder() const {
+    forEachInOrder([](int key) { std::cout << key << " "; });
+  }
+
+  // Обратный обход (post-order)
+  void postOrder() const {
+    forEachPostOrder([](int key) { std::cout << key << " "; });
+  }
+
+  // Сумма ключей в листьях; в B+-дереве в листьях лежат все ключи
+  long long sumOfLeaves() const {
+    long long sum = 0;
+    forEachInOrder([&sum](int key) { sum += key; });
+    return sum;
+  }
+
+  // Нахождение высоты дерева (число уровней)
+  int treeHeight() const { return keyCount == 0 ? 0 : levels; }
+
+  size_t size() const { return keyCount; }
+
+  // Освобождение всех узлов разом
+  void clear() {
+    leaves.clear();
+    inners.clear();
+    root = firstLeaf = newLeaf();
+    levels = 1;
+    keyCount = 0;
+  }
+};
+
+// Сравнение АВЛ-дерева и B+-дерева на n случайных ключах: вставка, поиск
+// существующих ключей и полный упорядоченный проход
+void benchmarkTrees(size_t maxCount) {
+  std::mt19937 generator(42);
+  for (size_t n = 10000; n <= maxCount; n *= 10) {
+    std::vector<int> keys(n);
+    for (size_t i = 0; i < n; ++i)
+      keys[i] = static_cast<int>(generator());
+    std::vector<int> queries(keys);
+    std::shuffle(queries.begin(), queries.end(), generator);
+
+    auto run = [&](auto &tree, const char *name) {
+      auto start = std::chrono::high_resolution_clock::now();
+      for (int key : keys)
+        tree.insert(key);
+      auto end = std::chrono::high_resolution_clock::now();
+      std::chrono::duration<double> insertTime = end - start;
+
+      start = std::chrono::high_resolution_clock::now();
+      size_t found = 0;
+      for (int key : queries)
+        found += tree.find(key);
+      end = std::chrono::high_resolution_clock::now();
+      std::chrono::duration<double> findTime = end - start;
+
+      start = std::chrono::high_resolution_clock::now();
+      long long sum = 0;
+      tree.forEachInOrder([&sum](int key) { sum += key; });
+      end = std::chrono::high_resolution_clock::now();
+      std::chrono::duration<double> scanTime = end - start;
+
+      std::cout << name << ": вставка " << n / insertTime.count() / 1e6
+                << " млн/с, поиск " << n / findTime.count() / 1e6
+                << " млн/с, проход " << n / scanTime.count() / 1e6
+                << " млн/с, найдено " << found << ", контрольная сумма " << sum
+                << std::endl;
+    };
+
+    std::cout << "Количество ключей: " << n << std::endl;
+    {
+      AVLTree avl;
+      run(avl, "АВЛ-дерево");
+    }
+    {
+      BPlusTree bplus;
+      run(bplus, "B+-дерево");
+    }
+    std::cout << "------------------------" << std::endl;
+  }
 }
 
-// Нахождение высоты дерева
-int treeHeight(Node *root) { return height(root); }
+// Неизменяемый узел персистентного АВЛ-дерева: версии дерева делят общие
+// поддеревья, владение — через счётчик ссылок
+struct PersistentNode;
+using PersistentPtr = std::shared_ptr<const PersistentNode>;
+
+struct PersistentNode {
+  int key;
+  int height;
+  long long leafSum;
+  PersistentPtr left;
+  PersistentPtr right;
+};
+
+// Наибольшее число одновременно открытых снимков
+const int MAX_READERS = 128;
+
+// Персистентное АВЛ-дерево для одного писателя и многих читателей. Вставка
+// копирует только путь от корня до нового узла и публикует новый корень
+// атомарной записью. Читатель берёт снимок без блокировок: объявляет текущую
+// эпоху в своей ячейке и читает корень. Старые версии освобождаются
+// писателем, когда все объявленные эпохи читателей стали больше эпохи замены
+class PersistentAVLTree {
+private:
+  struct alignas(64) ReaderSlot {
+    std::atomic<bool> used{false};
+    std::atomic<uint64_t> epoch{0};
+  };
+
+  std::atomic<const PersistentNode *> current{nullptr};
+  PersistentPtr currentOwner; // Доступен только писателю
+  std::atomic<uint64_t> globalEpoch{1};
+  ReaderSlot slots[MAX_READERS];
+  std::deque<std::pair<uint64_t, PersistentPtr>> retired; // Только писатель
+
+  static int height(const PersistentPtr &node) { return node ? node->height : 0; }
+
+  static PersistentPtr make(int key, PersistentPtr left, PersistentPtr right) {
+    int height = 1 + std::max(PersistentAVLTree::height(left),
+                              PersistentAVLTree::height(right));
+    long long leafSum = (left || right) ? (left ? left->leafSum : 0) +
+                                              (right ? right->leafSum : 0)
+                                        : key;
+    return std::make_shared<const PersistentNode>(
+        PersistentNode{key, height, leafSum, std::move(left), std::move(right)});
+  }
+
+  // Создание узла с восстановлением баланса: повороты тоже строят новые узлы
+  static PersistentPtr balance(int key, const PersistentPtr &left,
+                               const PersistentPtr &right) {
+    if (height(left) > height(right) + 1) {
+      if (height(left->left) >= height(left->right))
+        return make(left->key, left->left, make(key, left->right, right));
+      const PersistentPtr &middle = left->right;
+      return make(middle->key, make(left->key, left->left, middle->left),
+                  make(key, middle->right, right));
+    }
+    if (height(right) > height(left) + 1) {
+      if (height(right->right) >= height(right->left))
+        return make(right->key, make(key, left, right->left), right->right);
+      const PersistentPtr &middle = right->left;
+      return make(middle->key, make(key, left, middle->left),
+                  make(right->key, middle->right, right->right));
+    }
+    return make(key, left, right);
+  }
+
+  // Освобождение версий, которые уже не может видеть ни один читатель
+  void reclaim() {
+    uint64_t oldest = UINT64_MAX;
+    for (const ReaderSlot &slot : slots) {
+      uint64_t epoch = slot.epoch.load();
+      if (epoch != 0)
+        oldest = std::min(oldest, epoch);
+    }
+    while (!retired.empty() && retired.front().first < oldest)
+      retired.pop_front();
+  }
+
+public:
+  // Снимок дерева: пока он жив, его версия не освобождается
+  class Snapshot {
+  private:
+    ReaderSlot *slot;
+    const PersistentNode *root;
 
-void printTree(Node *root, int space = 0, int height = 10) {
-  // Увеличиваем расстояние между уровнями
-  int count = height;
+  public:
+    Snapshot(ReaderSlot *readerSlot, const PersistentNode *snapshotRoot)
+        : slot(readerSlot), root(snapshotRoot) {}
+    Snapshot(Snapshot &&other) noexcept : slot(other.slot), root(other.root) {
+      other.slot = nullptr;
+    }
+    Snapshot(const Snapshot &) = delete;
+    Snapshot &operator=(const Snapshot &) = delete;
+
+    ~Snapshot() {
+      if (slot) {
+        slot->epoch.store(0);
+        slot->used.store(false);
+      }
+    }
 
-  if (root == nullptr)
-    return;
+    // Поиск ключа в снимке
+    bool find(int key) const {
+      const PersistentNode *node = root;
+      while (node) {
+        if (key < node->key)
+          node = node->left.get();
+        else if (key > node->key)
+          node = node->right.get();
+        else
+          return true;
+      }
+      return false;
+    }
+
+    // Симметричный обход с явным стеком
+    template <typename F> void forEachInOrder(F visit) const {
+      const PersistentNode *stack[MAX_DEPTH];
+      int top = 0;
+      const PersistentNode *node = root;
+      while (node || top > 0) {
+        while (node) {
+          stack[top++] = node;
+          node = node->left.get();
+        }
+        node = stack[--top];
+        visit(node->key);
+        node = node->right.get();
+      }
+    }
 
-  // Увеличиваем расстояние между уровнями
-  space += count;
+    long long sumOfLeaves() const { return root ? root->leafSum : 0; }
 
-  // Рисуем правое поддерево
-  printTree(root->right, space);
+    int treeHeight() const { return root ? root->height : 0; }
+  };
 
-  // Выводим текущий узел после отступа
-  std::cout << std::endl;
-  for (int i = count; i < space; i++)
-    std::cout << " ";
-  std::cout << root->key << "\n";
+  PersistentAVLTree() = default;
+  PersistentAVLTree(const PersistentAVLTree &) = delete;
+  PersistentAVLTree &operator=(const PersistentAVLTree &) = delete;
 
-  // Рисуем левое поддерево
-  printTree(root->left, space);
+  // Вставка элемента (только из потока писателя); false для дубликата
+  bool insert(int key) {
+    const PersistentNode *path[MAX_DEPTH];
+    bool wentLeft[MAX_DEPTH];
+    int depth = 0;
+    const PersistentNode *node = currentOwner.get();
+    while (node) {
+      if (key == node->key)
+        return false; // Дубликаты не допускаются
+      path[depth] = node;
+      wentLeft[depth] = key < node->key;
+      node = wentLeft[depth] ? node->left.get() : node->right.get();
+      ++depth;
+    }
+
+    // Копирование пути снизу вверх, остальные поддеревья общие
+    PersistentPtr child = make(key, nullptr, nullptr);
+    for (int i = depth - 1; i >= 0; --i) {
+      const PersistentNode &original = *path[i];
+      child = wentLeft[i] ? balance(original.key, child, original.right)
+                          : balance(original.key, original.left, child);
+    }
+
+    retired.emplace_back(globalEpoch.load(), std::move(currentOwner));
+    currentOwner = std::move(child);
+    current.store(currentOwner.get());
+    globalEpoch.fetch_add(1);
+    reclaim();
+    return true;
+  }
+
+  // Снимок текущей версии без блокировок
+  Snapshot snapshot() {
+    for (int i = 0;; i = (i + 1) % MAX_READERS) {
+      bool expected = false;
+      if (!slots[i].used.load(std::memory_order_relaxed) &&
+          slots[i].used.compare_exchange_strong(expected, true)) {
+        slots[i].epoch.store(globalEpoch.load());
+        return Snapshot(&slots[i], current.load());
+      }
+      if (i == MAX_READERS - 1)
+        std::this_thread::yield();
+    }
+  }
+
+  // Число версий, ожидающих освобождения
+  size_t retiredVersions() const { return retired.size(); }
+};
+
+// Масштабирование читателей: потоки ищут ключи и считают сумму листьев
+// по снимкам, пока один писатель вставляет count ключей
+void benchmarkSnapshots(size_t count) {
+  unsigned hardware = std::max(1u, std::thread::hardware_concurrency());
+  for (unsigned readers = 1; readers <= hardware; readers *= 2) {
+    PersistentAVLTree tree;
+    std::atomic<bool> done{false};
+    std::vector<unsigned long long> operations(readers, 0);
+    std::vector<std::thread> threads;
+
+    auto start = std::chrono::high_resolution_clock::now();
+    for (unsigned r = 0; r < readers; ++r) {
+      threads.emplace_back([&tree, &done, &operations, r, count] {
+        std::mt19937 generator(r);
+        unsigned long long local = 0;
+        // Счётчик в регистре и одна запись в конце: соседние элементы
+        // operations лежат в одной строке кэша, и запись на каждой итерации
+        // гоняла бы её между ядрами, искажая масштабирование читателей
+        unsigned long long performed = 0;
+        while (!done.load(std::memory_order_relaxed)) {
+          PersistentAVLTree::Snapshot snapshot = tree.snapshot();
+          for (int i = 0; i < 64; ++i)
+            local += snapshot.find(static_cast<int>(generator() % (2 * count)));
+          local += snapshot.sumOfLeaves() != 0;
+          performed += 65;
+        }
+        operations[r] = performed;
+        (void)local;
+      });
+    }
+
+    std::mt19937 generator(42);
+    for (size_t i = 0; i < count; ++i)
+      tree.insert(static_cast<int>(generator() % (2 * count)));
+    auto writerEnd = std::chrono::high_resolution_clock::now();
+    done.store(true);
+    for (std::thread &thread : threads)
+      thread.join();
+    std::chrono::duration<double> duration = writerEnd - start;
+
+    unsigned long long total = 0;
+    for (unsigned long long ops : operations)
+      total += ops;
+    std::cout << "Читателей: " << readers << ", писатель: "
+              << count / duration.count() / 1e6 << " млн вставок/с, читатели: "
+              << total / duration.count() / 1e6 << " млн операций/с, ожидают "
+              << "освобождения версий: " << tree.retiredVersions() << std::endl;
+  }
 }
 
 // Меню для работы с деревом
-void menu(Node *&root) {
+void menu(AVLTree &tree) {
   int choice;
   do {
     std::cout << "1. Вставить элемент\n";
@@ -160,6 +1227,16 @@ void menu(Node *&root) {
     std::cout << "5. Нахождение высоты дерева\n";
     std::cout << "6. Выйти\n";
     std::cout << "7. Напечатать дерево\n";
+    std::cout << "8. Найти элемент\n";
+    std::cout << "9. Очистить дерево\n";
+    std::cout << "10. Удалить элемент\n";
+    std::cout << "11. Построить дерево из ключей 1..n\n";
+    std::cout << "12. Разрезать дерево по ключу\n";
+    std::cout << "13. Найти k-й по возрастанию ключ\n";
+    std::cout << "14. Найти ранг ключа\n";
+    std::cout << "15. Найти сумму ключей на отрезке\n";
+    std::cout << "16. Сравнить АВЛ-дерево и B+-дерево\n";
+    std::cout << "17. Параллельное чтение по снимкам\n";
     std::cout << "Выберите действие: ";
     std::cin >> choice;
 
@@ -168,31 +1245,112 @@ void menu(Node *&root) {
       int key;
       std::cout << "Введите ключ для вставки: ";
       std::cin >> key;
-      root = insert(root, key);
+      tree.insert(key);
       break;
     }
     case 2:
       std::cout << "Симметричный обход: ";
-      inOrder(root);
+      tree.inOrder();
       std::cout << std::endl;
       break;
     case 3:
       std::cout << "Обратный обход: ";
-      postOrder(root);
+      tree.postOrder();
       std::cout << std::endl;
                 break;
             case 4:
-                std::cout << "Сумма значений листьев: " << sumOfLeaves(root) << std::endl;
+                std::cout << "Сумма значений листьев: " << tree.sumOfLeaves() << std::endl;
                 break;
             case 5:
-                std::cout << "Высота дерева: " << treeHeight(root) << std::endl;
+                std::cout << "Высота дерева: " << tree.treeHeight() << std::endl;
                 break;
             case 6:
                 std::cout << "Выход..." << std::endl;
                 break;
             case 7:
-                printTree(root);
+                tree.printTree();
+                break;
+            case 8: {
+                int key;
+                std::cout << "Введите ключ для поиска: ";
+                std::cin >> key;
+                std::cout << (tree.find(key) ? "Элемент найден" : "Элемент не найден") << std::endl;
+                break;
+            }
+            case 9:
+                tree.clear();
+                std::cout << "Дерево очищено" << std::endl;
+                break;
+            case 10: {
+                int key;
+                std::cout << "Введите ключ для удаления: ";
+                std::cin >> key;
+                std::cout << (tree.erase(key) ? "Элемент удалён" : "Элемент не найден") << std::endl;
+                break;
+            }
+            case 11: {
+                int n;
+                std::cout << "Введите n: ";
+                std::cin >> n;
+                std::vector<int> keys(std::max(n, 0));
+                for (int i = 0; i < n; ++i)
+                    keys[i] = i + 1;
+                tree.buildFromSorted(keys.begin(), keys.end());
+                std::cout << "Высота дерева: " << tree.treeHeight() << std::endl;
+                break;
+            }
+            case 12: {
+                int key;
+                std::cout << "Введите ключ разреза: ";
+                std::cin >> key;
+                AVLTree upper = tree.split(key);
+                std::cout << "Ключи меньше " << key << ": ";
+                tree.inOrder();
+                std::cout << std::endl << "Остальные ключи: ";
+                upper.inOrder();
+                std::cout << std::endl;
+                tree.join(upper);
+                break;
+            }
+            case 13: {
+                uint32_t k;
+                int key;
+                std::cout << "Введите k: ";
+                std::cin >> k;
+                if (tree.kth(k, key))
+                    std::cout << k << "-й ключ: " << key << std::endl;
+                else
+                    std::cout << "k вне диапазона" << std::endl;
+                break;
+            }
+            case 14: {
+                int key;
+                std::cout << "Введите ключ: ";
+                std::cin >> key;
+                std::cout << "Ключей меньше " << key << ": " << tree.rank(key) << std::endl;
+                break;
+            }
+            case 15: {
+                int lo, hi;
+                std::cout << "Введите границы отрезка: ";
+                std::cin >> lo >> hi;
+                std::cout << "Сумма ключей: " << tree.rangeSum(lo, hi) << std::endl;
+                break;
+            }
+            case 16: {
+                size_t maxCount;
+                std::cout << "Введите наибольшее число ключей (от 10000 до 100000000): ";
+                std::cin >> maxCount;
+                benchmarkTrees(maxCount);
+                break;
+            }
+            case 17: {
+                size_t count;
+                std::cout << "Введите число вставок писателя: ";
+                std::cin >> count;
+                benchmarkSnapshots(count);
                 break;
+            }
             default:
                 std::cout << "Некорректный ввод, попробуйте снова." << std::endl;
                 break;
@@ -201,7 +1359,7 @@ void menu(Node *&root) {
 }
 
 int main() {
-    Node* root = nullptr;
-    menu(root);
+    AVLTree tree;
+    menu(tree);
     return 0;
 }
@@ -1,10 +1,34 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdint>
+#include <cstring>
 #include <fstream>
 #include <iostream>
 #include <limits>
+#include <mutex>
+#include <random>
+#include <thread>
 #include <vector>
 
+#include <fcntl.h> // Для отображения результатов в память (mmap)
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define SIAOD_X86_DISPATCH 1
+#endif
+
 const int INF = std::numeric_limits<int>::max(); // Определяем бесконечность
 
+// Бесконечность для векторных ядер: сумма двух таких значений не
+// переполняет int, поэтому проверка на INF во внутреннем цикле не нужна
+const int INF_SENTINEL = std::numeric_limits<int>::max() / 2;
+
 // Функция для вывода матрицы
 void printMatrix(const std::vector<std::vector<int>> &matrix) {
   int V = matrix.size();
@@ -20,8 +44,9 @@ void printMatrix(const std::vector<std::vector<int>> &matrix) {
   }
 }
 
-// Алгоритм Флойда для нахождения кратчайших путей
-void floydWarshall(std::vector<std::vector<int>> &graph) {
+// Алгоритм Флойда: вычисление матрицы кратчайших расстояний
+std::vector<std::vector<int>>
+shortestDistances(const std::vector<std::vector<int>> &graph) {
   int V = graph.size();
   std::vector<std::vector<int>> dist = graph;
 
@@ -35,29 +60,1341 @@ void floydWarshall(std::vector<std::vector<int>> &graph) {
       }
     }
   }
+  return dist;
+}
+
+// Алгоритм Флойда для нахождения кратчайших путей
+void floydWarshall(std::vector<std::vector<int>> &graph) {
+  std::vector<std::vector<int>> dist = shortestDistances(graph);
 
   std::cout << "Кратчайшие пути между всеми парами вершин:" << std::endl;
   printMatrix(dist);
 }
 
-int main() {
-  std::ifstream a("/Users/user/CLionProjects/siaod_speed_run/input.txt");
+// Плоская матрица V×V, строки лежат подряд в одном блоке памяти
+struct FlatMatrix {
   int V;
-  a >> V;
+  std::vector<int> data;
 
-  // Создаем матрицу смежности графа
-  std::vector<std::vector<int>> graph(V, std::vector<int>(V, INF));
+  explicit FlatMatrix(int size, int value = INF)
+      : V(size), data(static_cast<size_t>(size) * size, value) {}
+
+  explicit FlatMatrix(const std::vector<std::vector<int>> &matrix)
+      : FlatMatrix(static_cast<int>(matrix.size())) {
+    for (int i = 0; i < V; ++i)
+      std::copy(matrix[i].begin(), matrix[i].end(), row(i));
+  }
+
+  int *row(int i) { return data.data() + static_cast<size_t>(i) * V; }
+  const int *row(int i) const { return data.data() + static_cast<size_t>(i) * V; }
+
+  std::vector<std::vector<int>> toNested() const {
+    std::vector<std::vector<int>> matrix(V);
+    for (int i = 0; i < V; ++i)
+      matrix[i].assign(row(i), row(i) + V);
+    return matrix;
+  }
+};
+
+// Сложение с насыщением: бесконечное второе слагаемое даёт INF, переполнение
+// вверх — INF, вниз — минимальное int. Первое слагаемое вызывающий код уже
+// проверил на INF. Только 32-битные операции и выборки без ветвлений, поэтому
+// цикл по j векторизуется
+inline int addSaturated(int a, int b) {
+  int sum = static_cast<int>(static_cast<unsigned>(a) + static_cast<unsigned>(b));
+  bool overflow = ((a ^ sum) & (b ^ sum)) < 0;
+  int saturated = a > 0 ? INF : std::numeric_limits<int>::min();
+  return b == INF ? INF : (overflow ? saturated : sum);
+}
+
+// Ядро min-plus: rowI[j] = min(rowI[j], dik + rowK[j]) для j из [0, count)
+using MinPlusKernel = void (*)(int *rowI, const int *rowK, int dik, int count);
+
+// Точное ядро для произвольных весов: бесконечность INF, сложение с насыщением
+void minPlusSaturated(int *rowI, const int *rowK, int dik, int count) {
+  for (int j = 0; j < count; ++j)
+    rowI[j] = std::min(rowI[j], addSaturated(dik, rowK[j]));
+}
+
+// Скалярное ядро для бесконечности INF_SENTINEL
+void minPlusScalar(int *rowI, const int *rowK, int dik, int count) {
+  for (int j = 0; j < count; ++j)
+    rowI[j] = std::min(rowI[j], dik + rowK[j]);
+}
+
+#ifdef SIAOD_X86_DISPATCH
+// AVX2: 8 расстояний за инструкцию
+__attribute__((target("avx2"))) void minPlusAvx2(int *rowI, const int *rowK,
+                                                  int dik, int count) {
+  const __m256i d = _mm256_set1_epi32(dik);
+  int j = 0;
+  for (; j + 8 <= count; j += 8) {
+    __m256i through = _mm256_add_epi32(
+        d, _mm256_loadu_si256(reinterpret_cast<const __m256i *>(rowK + j)));
+    __m256i current = _mm256_loadu_si256(reinterpret_cast<__m256i *>(rowI + j));
+    _mm256_storeu_si256(reinterpret_cast<__m256i *>(rowI + j),
+                        _mm256_min_epi32(current, through));
+  }
+  for (; j < count; ++j)
+    rowI[j] = std::min(rowI[j], dik + rowK[j]);
+}
+
+// AVX-512: 16 расстояний за инструкцию. GCC 12 выдаёт ложное
+// предупреждение на _mm512_undefined_epi32 внутри заголовка интринсиков
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+__attribute__((target("avx512f"))) void minPlusAvx512(int *rowI,
+                                                       const int *rowK,
+                                                       int dik, int count) {
+  const __m512i d = _mm512_set1_epi32(dik);
+  int j = 0;
+  for (; j + 16 <= count; j += 16) {
+    __m512i through = _mm512_add_epi32(d, _mm512_loadu_si512(rowK + j));
+    __m512i current = _mm512_loadu_si512(rowI + j);
+    _mm512_storeu_si512(rowI + j, _mm512_min_epi32(current, through));
+  }
+  for (; j < count; ++j)
+    rowI[j] = std::min(rowI[j], dik + rowK[j]);
+}
+#pragma GCC diagnostic pop
+#endif
+
+// Выбор самого широкого ядра, поддерживаемого процессором
+MinPlusKernel selectMinPlusKernel(const char **name = nullptr) {
+  const char *selected = "скалярное";
+  MinPlusKernel kernel = minPlusScalar;
+#ifdef SIAOD_X86_DISPATCH
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx512f")) {
+    selected = "AVX-512";
+    kernel = minPlusAvx512;
+  } else if (__builtin_cpu_supports("avx2")) {
+    selected = "AVX2";
+    kernel = minPlusAvx2;
+  }
+#endif
+  if (name)
+    *name = selected;
+  return kernel;
+}
+
+// Релаксация плитки [i0, i1) × [j0, j1) через вершины [k0, k1)
+void relaxTile(FlatMatrix &dist, int i0, int i1, int j0, int j1, int k0,
+               int k1, MinPlusKernel kernel, int inf) {
+  for (int k = k0; k < k1; ++k) {
+    const int *rowK = dist.row(k);
+    for (int i = i0; i < i1; ++i) {
+      int *rowI = dist.row(i);
+      const int dik = rowI[k];
+      if (dik >= inf)
+        continue; // Через недостижимую вершину пути нет — вся строка пропускается
+      kernel(rowI + j0, rowK + j0, dik, j1 - j0);
+    }
+  }
+}
+
+// Можно ли считать в домене INF_SENTINEL: веса неотрицательны и даже
+// самый длинный простой путь не дотягивает до INF_SENTINEL
+bool fitsSentinel(const FlatMatrix &dist) {
+  long long maxWeight = 0;
+  for (int value : dist.data) {
+    if (value == INF)
+      continue;
+    if (value < 0)
+      return false;
+    maxWeight = std::max<long long>(maxWeight, value);
+  }
+  return maxWeight * std::max(1, dist.V - 1) < INF_SENTINEL;
+}
+
+// Выполнение task(0..count-1) в threads потоках
+template <typename Task> void parallelFor(int count, int threads, Task task) {
+  threads = std::max(1, std::min(threads, count));
+  if (threads == 1) {
+    for (int t = 0; t < count; ++t)
+      task(t);
+    return;
+  }
+  std::vector<std::thread> workers;
+  for (int w = 0; w < threads; ++w) {
+    workers.emplace_back([&task, w, threads, count] {
+      for (int t = w; t < count; t += threads)
+        task(t);
+    });
+  }
+  for (std::thread &worker : workers)
+    worker.join();
+}
+
+// Барьер для постоянных потоков: wait() возвращается, когда до него дошли
+// все count потоков
+class Barrier {
+private:
+  std::mutex mutex;
+  std::condition_variable released;
+  int count;
+  int waiting = 0;
+  unsigned long long generation = 0;
+
+public:
+  explicit Barrier(int threads) : count(threads) {}
+
+  void wait() {
+    std::unique_lock<std::mutex> lock(mutex);
+    unsigned long long current = generation;
+    if (++waiting == count) {
+      waiting = 0;
+      generation++;
+      released.notify_all();
+    } else {
+      released.wait(lock, [&] { return generation != current; });
+    }
+  }
+};
+
+// Порядок обхода плиток блочного алгоритма Флойда. Для каждого
+// диагонального блока kb:
+// 1) диагональная плитка (kb, kb);
+// 2) плитки строки kb и столбца kb, зависящие только от диагональной;
+// 3) все остальные плитки, зависящие только от строки и столбца kb.
+// Плитки внутри фаз 2 и 3 независимы и обрабатываются параллельно;
+// relax(i0, i1, j0, j1, k0, k1) релаксирует одну плитку
+template <typename Relax>
+void blockedSchedule(int V, int tileSize, int threads, Relax relax) {
+  const int tiles = (V + tileSize - 1) / tileSize;
+  auto begin = [tileSize](int t) { return t * tileSize; };
+  auto end = [tileSize, V](int t) { return std::min(V, (t + 1) * tileSize); };
+
+  for (int kb = 0; kb < tiles; ++kb) {
+    const int k0 = begin(kb), k1 = end(kb);
+    relax(k0, k1, k0, k1, k0, k1);
+
+    parallelFor(2 * tiles, threads, [&](int t) {
+      int other = t / 2;
+      if (other == kb)
+        return;
+      if (t % 2 == 0)
+        relax(k0, k1, begin(other), end(other), k0, k1);
+      else
+        relax(begin(other), end(other), k0, k1, k0, k1);
+    });
+
+    parallelFor(tiles * tiles, threads, [&](int t) {
+      int ib = t / tiles, jb = t % tiles;
+      if (ib == kb || jb == kb)
+        return;
+      relax(begin(ib), end(ib), begin(jb), end(jb), k0, k1);
+    });
+  }
+}
+
+// Блочный многопоточный алгоритм Флойда. Векторные ядра выбираются по
+// возможностям процессора; если веса не укладываются в домен INF_SENTINEL
+// (или vectorize == false), работает точное ядро с насыщением
+void floydWarshallBlocked(FlatMatrix &dist, int tileSize = 64,
+                          int threads = std::thread::hardware_concurrency(),
+                          bool vectorize = true) {
+  MinPlusKernel kernel = minPlusSaturated;
+  int inf = INF;
+  if (vectorize && fitsSentinel(dist)) {
+    kernel = selectMinPlusKernel();
+    inf = INF_SENTINEL;
+    std::replace(dist.data.begin(), dist.data.end(), INF, INF_SENTINEL);
+  }
+
+  blockedSchedule(dist.V, tileSize, threads,
+                  [&](int i0, int i1, int j0, int j1, int k0, int k1) {
+                    relaxTile(dist, i0, i1, j0, j1, k0, k1, kernel, inf);
+                  });
+
+  if (inf == INF_SENTINEL)
+    std::replace(dist.data.begin(), dist.data.end(), INF_SENTINEL, INF);
+}
+
+// Шаг k для строк [i0, i1) с обновлением матрицы следующих вершин: при
+// улучшении путь i -> j начинается так же, как путь i -> k. rowK — копия
+// строки k: её собственная полоса пишет в неё на этом же шаге
+template <typename Hop>
+void relaxRowsPaths(FlatMatrix &dist, Hop *next, int i0, int i1, int k,
+                    const int *rowK) {
+  const size_t V = dist.V;
+  for (int i = i0; i < i1; ++i) {
+    int *rowI = dist.row(i);
+    Hop *nextI = next + i * V;
+    const int dik = rowI[k];
+    if (dik == INF)
+      continue;
+    const Hop hop = nextI[k];
+    for (size_t j = 0; j < V; ++j) {
+      int through = addSaturated(dik, rowK[j]);
+      bool better = through < rowI[j];
+      rowI[j] = better ? through : rowI[j];
+      nextI[j] = better ? hop : nextI[j];
+    }
+  }
+}
+
+// Файл, отображённый в память только для чтения
+class MappedFile {
+private:
+  void *addr = nullptr;
+  size_t length = 0;
+
+public:
+  MappedFile() = default;
+  MappedFile(const MappedFile &) = delete;
+  MappedFile &operator=(const MappedFile &) = delete;
+
+  MappedFile(MappedFile &&other) noexcept : addr(other.addr), length(other.length) {
+    other.addr = nullptr;
+    other.length = 0;
+  }
+
+  MappedFile &operator=(MappedFile &&other) noexcept {
+    if (this != &other) {
+      close();
+      addr = other.addr;
+      length = other.length;
+      other.addr = nullptr;
+      other.length = 0;
+    }
+    return *this;
+  }
+
+  ~MappedFile() { close(); }
+
+  // false, если файл не открылся, пуст или не отображается
+  bool open(const std::string &fileName) {
+    close();
+    int fd = ::open(fileName.c_str(), O_RDONLY);
+    if (fd < 0)
+      return false;
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size == 0) {
+      ::close(fd);
+      return false;
+    }
+    void *mapped = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (mapped == MAP_FAILED)
+      return false;
+    addr = mapped;
+    length = st.st_size;
+    return true;
+  }
+
+  void close() {
+    if (addr) {
+      munmap(addr, length);
+      addr = nullptr;
+      length = 0;
+    }
+  }
+
+  const char *data() const { return static_cast<const char *>(addr); }
+  size_t size() const { return length; }
+};
+
+// Результат поиска кратчайших путей между всеми парами вершин: матрица
+// расстояний и (необязательно) матрица следующих вершин. Для V < 65536
+// следующая вершина хранится 16-битной. Результат сохраняется в двоичный
+// файл и загружается обратно отображением в память без копирования
+class ShortestPaths {
+private:
+  int V = 0;
+  int hopWidth = 0; // 0 — пути не сохранены, иначе 2 или 4 байта
+  std::vector<int> distStorage;
+  std::vector<uint8_t> nextStorage;
+  const int *dist = nullptr;
+  const uint8_t *next = nullptr;
+  MappedFile file;
+
+  static constexpr char magic[8] = {'S', 'I', 'A', 'O', 'D', 'S', 'P', '1'};
+
+  uint32_t hop(int u, int v) const {
+    size_t index = static_cast<size_t>(u) * V + v;
+    if (hopWidth == 2) {
+      uint16_t value;
+      std::memcpy(&value, next + index * 2, 2);
+      return value == UINT16_MAX ? UINT32_MAX : value;
+    }
+    uint32_t value;
+    std::memcpy(&value, next + index * 4, 4);
+    return value;
+  }
+
+  template <typename Hop>
+  void computePaths(FlatMatrix &matrix, int tileSize, int threads) {
+    nextStorage.assign(static_cast<size_t>(V) * V * sizeof(Hop), 0);
+    Hop *hops = reinterpret_cast<Hop *>(nextStorage.data());
+    const Hop none = std::numeric_limits<Hop>::max();
+    for (int i = 0; i < V; ++i) {
+      for (int j = 0; j < V; ++j)
+        hops[static_cast<size_t>(i) * V + j] =
+            (i == j || matrix.row(i)[j] != INF) ? static_cast<Hop>(j) : none;
+    }
+    // Строгое правило < даёт корректные переходы только при обычном порядке
+    // с внешним циклом по k: в блочном порядке строка k бывает улучшена
+    // более поздними k, и на циклах нулевого веса переходы зацикливаются.
+    // Поэтому k идут подряд, а полосы строк делят постоянные потоки с
+    // барьером после каждого k. Строка k читается из копии; копию строки
+    // k + 1 снимает владелец её полосы сразу после своего шага k, во второй
+    // буфер, который на шаге k никто не читает. Столбец k — элемент
+    // собственной строки и читается до её обновления
+    if (V == 0)
+      return;
+    const int bands = (V + tileSize - 1) / tileSize;
+    const int workers = std::max(1, std::min(threads, bands));
+    std::vector<int> pivot[2] = {
+        std::vector<int>(matrix.row(0), matrix.row(0) + V),
+        std::vector<int>(V)};
+    Barrier barrier(workers);
+    auto work = [&](int w) {
+      for (int k = 0; k < V; ++k) {
+        for (int band = w; band < bands; band += workers)
+          relaxRowsPaths(matrix, hops, band * tileSize,
+                         std::min(V, (band + 1) * tileSize), k,
+                         pivot[k % 2].data());
+        if (k + 1 < V && (k + 1) / tileSize % workers == w)
+          std::copy(matrix.row(k + 1), matrix.row(k + 1) + V,
+                    pivot[(k + 1) % 2].begin());
+        barrier.wait();
+      }
+    };
+    std::vector<std::thread> pool;
+    for (int w = 1; w < workers; ++w)
+      pool.emplace_back(work, w);
+    work(0);
+    for (std::thread &thread : pool)
+      thread.join();
+  }
+
+public:
+  ShortestPaths() = default;
+  ShortestPaths(const ShortestPaths &) = delete;
+  ShortestPaths &operator=(const ShortestPaths &) = delete;
+
+  ShortestPaths(ShortestPaths &&other) noexcept { *this = std::move(other); }
+
+  ShortestPaths &operator=(ShortestPaths &&other) noexcept {
+    if (this != &other) {
+      V = other.V;
+      hopWidth = other.hopWidth;
+      distStorage = std::move(other.distStorage);
+      nextStorage = std::move(other.nextStorage);
+      dist = other.dist;
+      next = other.next;
+      file = std::move(other.file);
+      other.dist = nullptr;
+      other.next = nullptr;
+      other.V = 0;
+    }
+    return *this;
+  }
+
+  // Вычисление блочным алгоритмом Флойда. С withPaths дополнительно строится
+  // матрица следующих вершин (в этом режиме работает точное скалярное ядро
+  // в обычном порядке по k, без блоков)
+  static ShortestPaths compute(const std::vector<std::vector<int>> &graph,
+                               bool withPaths = true, int tileSize = 64,
+                               int threads = std::thread::hardware_concurrency()) {
+    return compute(FlatMatrix(graph), withPaths, tileSize, threads);
+  }
+
+  // То же для плоской матрицы; её память переиспользуется под расстояния
+  static ShortestPaths compute(FlatMatrix matrix, bool withPaths = true,
+                               int tileSize = 64,
+                               int threads = std::thread::hardware_concurrency()) {
+    ShortestPaths result;
+    result.V = matrix.V;
+    if (!withPaths) {
+      floydWarshallBlocked(matrix, tileSize, threads);
+    } else if (result.V < 65536) {
+      result.hopWidth = 2;
+      result.computePaths<uint16_t>(matrix, tileSize, threads);
+    } else {
+      result.hopWidth = 4;
+      result.computePaths<uint32_t>(matrix, tileSize, threads);
+    }
+    result.distStorage = std::move(matrix.data);
+    result.dist = result.distStorage.data();
+    result.next = result.nextStorage.empty() ? nullptr : result.nextStorage.data();
+    return result;
+  }
+
+  int size() const { return V; }
+  bool hasPaths() const { return hopWidth != 0; }
+
+  // Есть ли вершина с таким номером: номера приходят из запросов
+  bool contains(int u) const {
+    return static_cast<unsigned>(u) < static_cast<unsigned>(V);
+  }
+
+  // Расстояние от u до v (INF, если v недостижима или номер вне [0, V))
+  int distance(int u, int v) const {
+    if (!contains(u) || !contains(v))
+      return INF;
+    return dist[static_cast<size_t>(u) * V + v];
+  }
 
+  // Строка расстояний от u; nullptr, если номер вне [0, V)
+  const int *row(int u) const {
+    return contains(u) ? dist + static_cast<size_t>(u) * V : nullptr;
+  }
+
+  // Матрица расстояний в виде вложенных векторов
+  std::vector<std::vector<int>> distanceMatrix() const {
+    std::vector<std::vector<int>> matrix(V);
+    for (int i = 0; i < V; ++i)
+      matrix[i].assign(row(i), row(i) + V);
+    return matrix;
+  }
+
+  // Вершины кратчайшего пути от u до v включительно; пусто, если пути нет,
+  // номер вне [0, V) или матрица следующих вершин не строилась
+  std::vector<int> path(int u, int v) const {
+    std::vector<int> result;
+    if (!hasPaths() || distance(u, v) == INF)
+      return result;
+    result.push_back(u);
+    while (u != v) {
+      // Сравнение без знака: 0xFFFFFFFF из повреждённого файла не станет -1
+      uint32_t step = hop(u, v);
+      if (step >= static_cast<uint32_t>(V) ||
+          static_cast<int>(result.size()) > V)
+        return {}; // Отрицательный цикл или повреждённые данные
+      u = static_cast<int>(step);
+      result.push_back(u);
+    }
+    return result;
+  }
+
+  // Сохранение: заголовок, V, ширина следующей вершины, расстояния, переходы
+  bool save(const std::string &fileName) const {
+    std::ofstream out(fileName, std::ios::binary);
+    if (!out)
+      return false;
+    int32_t header[2] = {V, hopWidth};
+    out.write(magic, sizeof(magic));
+    out.write(reinterpret_cast<const char *>(header), sizeof(header));
+    out.write(reinterpret_cast<const char *>(dist),
+              static_cast<std::streamsize>(sizeof(int)) * V * V);
+    if (hasPaths())
+      out.write(reinterpret_cast<const char *>(next),
+                static_cast<std::streamsize>(hopWidth) * V * V);
+    return static_cast<bool>(out);
+  }
+
+  // Загрузка отображением файла в память
+  bool load(const std::string &fileName) {
+    MappedFile mapped;
+    if (!mapped.open(fileName) || mapped.size() < 16)
+      return false;
+
+    const char *base = mapped.data();
+    int32_t header[2];
+    std::memcpy(header, base + 8, sizeof(header));
+    long long cells = static_cast<long long>(header[0]) * header[0];
+    if (std::memcmp(base, magic, sizeof(magic)) != 0 || header[0] < 0 ||
+        (header[1] != 0 && header[1] != 2 && header[1] != 4) ||
+        static_cast<long long>(mapped.size()) != 16 + cells * (4 + header[1]))
+      return false;
+
+    file = std::move(mapped);
+    V = header[0];
+    hopWidth = header[1];
+    dist = reinterpret_cast<const int *>(base + 16);
+    next = hopWidth ? reinterpret_cast<const uint8_t *>(base + 16 + cells * 4)
+                    : nullptr;
+    distStorage.clear();
+    nextStorage.clear();
+    return true;
+  }
+};
+
+constexpr char ShortestPaths::magic[8];
+
+// Ребро ориентированного графа
+struct Edge {
+  int from;
+  int to;
+  int weight;
+};
+
+// Разреженный граф в формате CSR: исходящие рёбра вершины u занимают
+// отрезок [offsets[u], offsets[u + 1]) массивов targets и weights
+struct CsrGraph {
+  int V = 0;
+  std::vector<int> offsets;
+  std::vector<int> targets;
+  std::vector<int> weights;
+
+  // Построение сортировкой подсчётом по начальной вершине
+  static CsrGraph fromEdges(int V, const std::vector<Edge> &edges) {
+    CsrGraph graph;
+    graph.V = V;
+    graph.offsets.assign(V + 1, 0);
+    for (const Edge &edge : edges)
+      ++graph.offsets[edge.from + 1];
+    for (int u = 0; u < V; ++u)
+      graph.offsets[u + 1] += graph.offsets[u];
+    graph.targets.resize(edges.size());
+    graph.weights.resize(edges.size());
+    std::vector<int> position(graph.offsets.begin(), graph.offsets.end() - 1);
+    for (const Edge &edge : edges) {
+      int slot = position[edge.from]++;
+      graph.targets[slot] = edge.to;
+      graph.weights[slot] = edge.weight;
+    }
+    return graph;
+  }
+
+  // Преобразование матрицы смежности (INF — нет ребра)
+  static CsrGraph fromMatrix(const std::vector<std::vector<int>> &matrix) {
+    std::vector<Edge> edges;
+    int V = static_cast<int>(matrix.size());
+    for (int i = 0; i < V; ++i) {
+      for (int j = 0; j < V; ++j) {
+        if (i != j && matrix[i][j] != INF)
+          edges.push_back({i, j, matrix[i][j]});
+      }
+    }
+    return fromEdges(V, edges);
+  }
+
+  size_t edgeCount() const { return targets.size(); }
+};
+
+// Разбор целых чисел прямо из отображённого в память текста, без iostream
+class IntScanner {
+private:
+  const char *current;
+  const char *end;
+
+public:
+  IntScanner(const char *begin, const char *finish)
+      : current(begin), end(finish) {}
+
+  // Следующее число; false в конце текста или при постороннем символе
+  bool next(int &value) {
+    while (current < end && (*current == ' ' || *current == '\n' ||
+                             *current == '\r' || *current == '\t'))
+      ++current;
+    bool negative = current < end && *current == '-';
+    if (negative)
+      ++current;
+    if (current == end || *current < '0' || *current > '9')
+      return false;
+    long long result = 0;
+    while (current < end && *current >= '0' && *current <= '9') {
+      result = result * 10 + (*current - '0');
+      if (result > INF)
+        return false;
+      ++current;
+    }
+    value = static_cast<int>(negative ? -result : result);
+    return true;
+  }
+};
+
+// Загрузка списка рёбер: в первой строке V и E, далее E строк "u v w"
+// с вершинами, пронумерованными с нуля
+bool loadEdgeList(const std::string &fileName, CsrGraph &graph) {
+  MappedFile file;
+  if (!file.open(fileName))
+    return false;
+  IntScanner scanner(file.data(), file.data() + file.size());
+  int V, E;
+  if (!scanner.next(V) || !scanner.next(E) || V < 0 || E < 0)
+    return false;
+  // Заголовок сверяется с длиной файла до выделения памяти: число в тексте
+  // занимает хотя бы 2 байта с разделителем, у ребра их три. Вершин больше,
+  // чем байтов в файле, у настоящего списка рёбер не бывает
+  if (static_cast<uint64_t>(E) * 3 * 2 > file.size() ||
+      static_cast<uint64_t>(V) > file.size())
+    return false;
+  std::vector<Edge> edges(E);
+  for (Edge &edge : edges) {
+    if (!scanner.next(edge.from) || !scanner.next(edge.to) ||
+        !scanner.next(edge.weight) || edge.from < 0 || edge.from >= V ||
+        edge.to < 0 || edge.to >= V)
+      return false;
+  }
+  graph = CsrGraph::fromEdges(V, edges);
+  return true;
+}
+
+// Загрузка текстовой матрицы смежности: V, затем V² весов, 0 — нет ребра
+bool loadMatrixText(const std::string &fileName, FlatMatrix &matrix) {
+  MappedFile file;
+  if (!file.open(fileName))
+    return false;
+  IntScanner scanner(file.data(), file.data() + file.size());
+  int V;
+  if (!scanner.next(V) || V < 0)
+    return false;
+  // V² весов по 2 байта текста минимум: иначе файл обрезан или повреждён,
+  // и выделять под матрицу нечего
+  if (static_cast<uint64_t>(V) * V * 2 > file.size())
+    return false;
+  matrix = FlatMatrix(V);
   for (int i = 0; i < V; ++i) {
+    int *row = matrix.row(i);
     for (int j = 0; j < V; ++j) {
       int weight;
-      a >> weight;
-      if (i == j) {
-        graph[i][j] = 0; // Расстояние от вершины до самой себя
-      } else if (weight != 0) {
-        graph[i][j] = weight;
+      if (!scanner.next(weight))
+        return false;
+      if (i == j)
+        row[j] = 0; // Расстояние от вершины до самой себя
+      else if (weight != 0)
+        row[j] = weight;
+    }
+  }
+  return true;
+}
+
+// Двоичный формат графа: сигнатура, вид (0 — матрица V×V, 1 — список рёбер),
+// V, число записей и сами записи из int32. Загружается одним mmap
+const char GRAPH_MAGIC[8] = {'S', 'I', 'A', 'O', 'D', 'G', 'R', '1'};
+const int GRAPH_MATRIX = 0;
+const int GRAPH_EDGES = 1;
+
+struct GraphHeader {
+  char magic[8];
+  int32_t kind;
+  int32_t V;
+  int64_t count;
+};
+
+bool saveGraphBinary(const std::string &fileName, int kind, int V,
+                     const void *records, int64_t count, size_t recordSize) {
+  std::ofstream out(fileName, std::ios::binary);
+  if (!out)
+    return false;
+  GraphHeader header;
+  std::memcpy(header.magic, GRAPH_MAGIC, sizeof(GRAPH_MAGIC));
+  header.kind = kind;
+  header.V = V;
+  header.count = count;
+  out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+  out.write(static_cast<const char *>(records),
+            static_cast<std::streamsize>(count * recordSize));
+  return static_cast<bool>(out);
+}
+
+bool saveMatrixBinary(const std::string &fileName, const FlatMatrix &matrix) {
+  return saveGraphBinary(fileName, GRAPH_MATRIX, matrix.V, matrix.data.data(),
+                         static_cast<int64_t>(matrix.data.size()), sizeof(int));
+}
+
+bool saveEdgesBinary(const std::string &fileName, int V,
+                     const std::vector<Edge> &edges) {
+  return saveGraphBinary(fileName, GRAPH_EDGES, V, edges.data(),
+                         static_cast<int64_t>(edges.size()), sizeof(Edge));
+}
+
+// Граф, загруженный из файла: плотный (матрица) или разреженный (CSR)
+struct LoadedGraph {
+  bool dense = true;
+  FlatMatrix matrix{0};
+  CsrGraph csr;
+};
+
+// Загрузка графа: двоичный файл узнаётся по сигнатуре, текст читается как
+// матрица смежности или (при edgeList) как список рёбер
+bool loadGraph(const std::string &fileName, bool edgeList, LoadedGraph &graph) {
+  MappedFile file;
+  if (!file.open(fileName))
+    return false;
+  if (file.size() < sizeof(GraphHeader) ||
+      std::memcmp(file.data(), GRAPH_MAGIC, sizeof(GRAPH_MAGIC)) != 0) {
+    file.close();
+    graph.dense = !edgeList;
+    return edgeList ? loadEdgeList(fileName, graph.csr)
+                    : loadMatrixText(fileName, graph.matrix);
+  }
+
+  GraphHeader header;
+  std::memcpy(&header, file.data(), sizeof(header));
+  const char *payload = file.data() + sizeof(header);
+  size_t payloadSize = file.size() - sizeof(header);
+  if (header.V < 0 || header.count < 0)
+    return false;
+  if (header.kind == GRAPH_MATRIX) {
+    int64_t cells = static_cast<int64_t>(header.V) * header.V;
+    if (header.count != cells || payloadSize != cells * sizeof(int))
+      return false;
+    graph.dense = true;
+    graph.matrix = FlatMatrix(header.V);
+    std::memcpy(graph.matrix.data.data(), payload, payloadSize);
+    return true;
+  }
+  // Число рёбер сравнивается делением: произведение count * sizeof(Edge)
+  // из чужого заголовка может переполниться
+  if (header.kind == GRAPH_EDGES &&
+      static_cast<uint64_t>(header.count) == payloadSize / sizeof(Edge) &&
+      payloadSize % sizeof(Edge) == 0 &&
+      static_cast<uint64_t>(header.V) <= file.size()) {
+    const Edge *edges = reinterpret_cast<const Edge *>(payload);
+    for (int64_t e = 0; e < header.count; ++e) {
+      if (edges[e].from < 0 || edges[e].from >= header.V || edges[e].to < 0 ||
+          edges[e].to >= header.V)
+        return false;
+    }
+    graph.dense = false;
+    graph.csr = CsrGraph::fromEdges(
+        header.V, std::vector<Edge>(edges, edges + header.count));
+    return true;
+  }
+  return false;
+}
+
+// Кратчайшие пути в разреженном графе без построения матрицы V×V: алгоритм
+// Дейкстры от каждого нужного источника. При отрицательных весах рёбра
+// перевзвешиваются по Джонсону потенциалами из алгоритма Беллмана-Форда
+class SparseShortestPaths {
+private:
+  const CsrGraph &graph;
+  std::vector<long long> potential; // h(v); пусто, если веса неотрицательны
+  bool negativeCycle = false;
+
+  // Рабочие массивы одного потока, переиспользуются между источниками
+  struct Workspace {
+    std::vector<long long> dist;
+    std::vector<std::pair<long long, int>> heap;
+  };
+
+  long long reweighted(int u, int slot) const {
+    long long w = graph.weights[slot];
+    return potential.empty() ? w
+                             : w + potential[u] - potential[graph.targets[slot]];
+  }
+
+  // Дейкстра по перевзвешенным рёбрам от нескольких источников с
+  // начальными расстояниями -h(s); результат пересчитывается в исходные веса.
+  // При цикле отрицательного веса расстояний нет, а очередь с ленивым
+  // удалением на отрицательных рёбрах может не опустеть: результат пуст
+  void run(const std::vector<int> &sources, Workspace &ws,
+           std::vector<int> &result) const {
+    if (!valid()) {
+      result.clear();
+      return;
+    }
+    const long long unreached = std::numeric_limits<long long>::max();
+    ws.dist.assign(graph.V, unreached);
+    ws.heap.clear();
+    std::greater<std::pair<long long, int>> later;
+    for (int s : sources) {
+      long long start = potential.empty() ? 0 : -potential[s];
+      if (start < ws.dist[s]) {
+        ws.dist[s] = start;
+        ws.heap.push_back({start, s});
+        std::push_heap(ws.heap.begin(), ws.heap.end(), later);
+      }
+    }
+    while (!ws.heap.empty()) {
+      std::pop_heap(ws.heap.begin(), ws.heap.end(), later);
+      std::pair<long long, int> top = ws.heap.back();
+      ws.heap.pop_back();
+      int u = top.second;
+      if (top.first != ws.dist[u])
+        continue; // Устаревшая запись кучи
+      for (int slot = graph.offsets[u]; slot < graph.offsets[u + 1]; ++slot) {
+        int v = graph.targets[slot];
+        long long candidate = top.first + reweighted(u, slot);
+        if (candidate < ws.dist[v]) {
+          ws.dist[v] = candidate;
+          ws.heap.push_back({candidate, v});
+          std::push_heap(ws.heap.begin(), ws.heap.end(), later);
+        }
+      }
+    }
+
+    result.resize(graph.V);
+    for (int v = 0; v < graph.V; ++v) {
+      if (ws.dist[v] == unreached) {
+        result[v] = INF;
+        continue;
+      }
+      long long d = ws.dist[v] + (potential.empty() ? 0 : potential[v]);
+      result[v] = static_cast<int>(std::min<long long>(d, INF));
+    }
+  }
+
+public:
+  explicit SparseShortestPaths(const CsrGraph &csr) : graph(csr) {
+    bool hasNegative = std::any_of(graph.weights.begin(), graph.weights.end(),
+                                   [](int w) { return w < 0; });
+    if (!hasNegative)
+      return;
+
+    // Беллман-Форд от фиктивной вершины с нулевыми рёбрами во все вершины
+    potential.assign(graph.V, 0);
+    for (int iteration = 0; iteration <= graph.V; ++iteration) {
+      bool changed = false;
+      for (int u = 0; u < graph.V; ++u) {
+        for (int slot = graph.offsets[u]; slot < graph.offsets[u + 1]; ++slot) {
+          long long candidate = potential[u] + graph.weights[slot];
+          if (candidate < potential[graph.targets[slot]]) {
+            potential[graph.targets[slot]] = candidate;
+            changed = true;
+          }
+        }
       }
+      if (!changed)
+        return;
     }
+    negativeCycle = true;
+  }
+
+  // Движок хранит ссылку на граф, временный граф передавать нельзя
+  explicit SparseShortestPaths(CsrGraph &&) = delete;
+
+  // false, если в графе есть цикл отрицательного веса
+  bool valid() const { return !negativeCycle; }
+
+  // Расстояния от одного источника; пусто, если valid() == false
+  std::vector<int> singleSource(int source) const {
+    Workspace ws;
+    std::vector<int> result;
+    run({source}, ws, result);
+    return result;
+  }
+
+  // Расстояния до каждой вершины от ближайшего из источников; пусто, если
+  // valid() == false
+  std::vector<int> multiSource(const std::vector<int> &sources) const {
+    Workspace ws;
+    std::vector<int> result;
+    run(sources, ws, result);
+    return result;
+  }
+
+  // Строки матрицы расстояний для каждого источника из sources, вычисляемые
+  // пулом потоков: потоки разбирают источники через общий счётчик.
+  // visit(source, row) вызывается из рабочих потоков и должен быть
+  // потокобезопасным; строка действительна только во время вызова. При
+  // цикле отрицательного веса visit не вызывается ни разу
+  template <typename Visit>
+  void forEachSource(const std::vector<int> &sources, int threads,
+                     Visit visit) const {
+    if (!valid())
+      return;
+    std::atomic<size_t> nextSource{0};
+    auto worker = [&] {
+      Workspace ws;
+      std::vector<int> row;
+      for (size_t i = nextSource++; i < sources.size(); i = nextSource++) {
+        run({sources[i]}, ws, row);
+        visit(sources[i], row);
+      }
+    };
+    threads = std::max(1, threads);
+    std::vector<std::thread> pool;
+    for (int t = 1; t < threads; ++t)
+      pool.emplace_back(worker);
+    worker();
+    for (std::thread &thread : pool)
+      thread.join();
+  }
+
+  // Все пары: поток строк по всем источникам
+  template <typename Visit> void allPairs(int threads, Visit visit) const {
+    std::vector<int> sources(graph.V);
+    for (int v = 0; v < graph.V; ++v)
+      sources[v] = v;
+    forEachSource(sources, threads, visit);
+  }
+};
+
+// Случайный разреженный граф со средней степенью degree
+CsrGraph generateSparseGraph(int V, int degree, unsigned seed) {
+  std::mt19937 generator(seed);
+  std::uniform_int_distribution<> vertex(0, V - 1);
+  std::uniform_int_distribution<> weight(1, 100);
+  std::vector<Edge> edges;
+  edges.reserve(static_cast<size_t>(V) * degree);
+  for (int u = 0; u < V; ++u) {
+    for (int e = 0; e < degree; ++e)
+      edges.push_back({u, vertex(generator), weight(generator)});
+  }
+  return CsrGraph::fromEdges(V, edges);
+}
+
+// Все пары кратчайших путей в разреженном графе: строки не сохраняются,
+// только сворачиваются в контрольную сумму
+void benchmarkSparse(int V, int degree) {
+  CsrGraph graph = generateSparseGraph(V, degree, 42);
+  SparseShortestPaths engine(graph);
+  int threads = std::max(1u, std::thread::hardware_concurrency());
+  std::atomic<long long> checksum{0};
+
+  auto start = std::chrono::high_resolution_clock::now();
+  engine.allPairs(threads, [&checksum](int, const std::vector<int> &row) {
+    long long local = 0;
+    for (int d : row)
+      local += d == INF ? 0 : d;
+    checksum += local;
+  });
+  auto end = std::chrono::high_resolution_clock::now();
+  std::chrono::duration<double> duration = end - start;
+
+  std::cout << "Разреженный граф V = " << V << ", E = " << graph.edgeCount()
+            << ": все пары за " << duration.count() * 1000 << " мс ("
+            << threads << " потоков), контрольная сумма " << checksum.load()
+            << std::endl;
+}
+
+// Случайный ориентированный граф: ребро существует с вероятностью density
+std::vector<std::vector<int>> generateGraph(int V, double density,
+                                            unsigned seed) {
+  std::mt19937 generator(seed);
+  std::uniform_real_distribution<> edge(0.0, 1.0);
+  std::uniform_int_distribution<> weight(1, 100);
+  std::vector<std::vector<int>> graph(V, std::vector<int>(V, INF));
+  for (int i = 0; i < V; ++i) {
+    for (int j = 0; j < V; ++j) {
+      if (i == j)
+        graph[i][j] = 0;
+      else if (edge(generator) < density)
+        graph[i][j] = weight(generator);
+    }
+  }
+  return graph;
+}
+
+// Матрица кратчайших расстояний с инкрементальным обновлением при изменении
+// веса одного ребра вместо полного пересчёта за O(V³)
+class DynamicShortestPaths {
+private:
+  FlatMatrix weights; // Текущие веса рёбер, INF — ребра нет
+  FlatMatrix dist;
+  std::vector<std::vector<int>> outgoing; // Списки смежности; рёбра с весом
+  std::vector<std::vector<int>> incoming; // INF в них пропускаются
+  bool hasNegative = false;
+  int threads;
+
+  void recomputeAll() {
+    dist = weights;
+    floydWarshallBlocked(dist, 64, threads);
+  }
+
+  // Восстановление строки source после подорожания ребра u -> v. Меняться
+  // могут только расстояния до вершин из множества T, чей кратчайший путь
+  // проходил через это ребро. Для них берётся лучшая оценка через
+  // предшественников вне T, затем Дейкстра внутри T
+  void repairRow(int source, int u, int oldWeight, const std::vector<int> &rowV,
+                 std::vector<char> &inT) {
+    const int V = dist.V;
+    int *row = dist.row(source);
+    const int throughEdge = addSaturated(row[u], oldWeight);
+    std::vector<int> targets;
+    for (int j = 0; j < V; ++j) {
+      // Сам источник остаётся на расстоянии 0 даже при цикле нулевого веса
+      if (j != source && rowV[j] != INF &&
+          addSaturated(throughEdge, rowV[j]) == row[j]) {
+        inT[j] = 1;
+        targets.push_back(j);
+      }
+    }
+
+    std::vector<std::pair<int, int>> heap;
+    std::greater<std::pair<int, int>> later;
+    for (int j : targets) {
+      int best = INF;
+      for (int k : incoming[j]) {
+        int w = weights.row(k)[j];
+        if (!inT[k] && w != INF && row[k] != INF)
+          best = std::min(best, addSaturated(row[k], w));
+      }
+      row[j] = best;
+      if (best != INF)
+        heap.push_back({best, j});
+    }
+    std::make_heap(heap.begin(), heap.end(), later);
+    while (!heap.empty()) {
+      std::pop_heap(heap.begin(), heap.end(), later);
+      std::pair<int, int> top = heap.back();
+      heap.pop_back();
+      int x = top.second;
+      if (top.first != row[x])
+        continue;
+      for (int y : outgoing[x]) {
+        int w = weights.row(x)[y];
+        if (!inT[y] || w == INF)
+          continue;
+        int candidate = addSaturated(top.first, w);
+        if (candidate < row[y]) {
+          row[y] = candidate;
+          heap.push_back({candidate, y});
+          std::push_heap(heap.begin(), heap.end(), later);
+        }
+      }
+    }
+
+    for (int j : targets)
+      inT[j] = 0;
+  }
+
+public:
+  explicit DynamicShortestPaths(const std::vector<std::vector<int>> &graph,
+                                int threadCount = std::thread::hardware_concurrency())
+      : weights(graph), dist(graph), outgoing(graph.size()),
+        incoming(graph.size()), threads(std::max(1, threadCount)) {
+    const int V = weights.V;
+    for (int u = 0; u < V; ++u) {
+      for (int v = 0; v < V; ++v) {
+        int w = weights.row(u)[v];
+        hasNegative = hasNegative || w < 0;
+        if (u != v && w != INF) {
+          outgoing[u].push_back(v);
+          incoming[v].push_back(u);
+        }
+      }
+    }
+    recomputeAll();
+  }
+
+  int size() const { return dist.V; }
+  int distance(int u, int v) const { return dist.row(u)[v]; }
+  const FlatMatrix &distances() const { return dist; }
+
+  // Изменение веса ребра u -> v (INF удаляет ребро). Возвращает число
+  // затронутых строк (0 для удешевления ребра)
+  int setEdge(int u, int v, int weight) {
+    const int V = dist.V;
+    const int oldWeight = weights.row(u)[v];
+    if (u == v || weight == oldWeight)
+      return 0;
+    weights.row(u)[v] = weight;
+    hasNegative = hasNegative || weight < 0;
+    if (oldWeight == INF) {
+      outgoing[u].push_back(v);
+      incoming[v].push_back(u);
+    } else if (weight == INF) {
+      // Удалённое ребро убирается из списков, иначе повторное добавление
+      // продублирует его и списки будут расти при каждом переключении
+      auto erase = [](std::vector<int> &list, int value) {
+        auto it = std::find(list.begin(), list.end(), value);
+        *it = list.back();
+        list.pop_back();
+      };
+      erase(outgoing[u], v);
+      erase(incoming[v], u);
+    }
+
+    if (weight < oldWeight) {
+      // Ребро подешевело: d[i][j] = min(d[i][j], d[i][u] + w + d[v][j]),
+      // O(V²). Строка v и столбец u при этом не меняются, поэтому обновление
+      // на месте корректно. Строка v копируется: поток со строкой i == v
+      // пишет в неё, пока остальные её читают
+      const std::vector<int> rowV(dist.row(v), dist.row(v) + V);
+      parallelFor(V, threads, [&](int i) {
+        int *rowI = dist.row(i);
+        if (rowI[u] == INF)
+          return;
+        minPlusSaturated(rowI, rowV.data(), addSaturated(rowI[u], weight), V);
+      });
+      return 0;
+    }
+
+    // Ребро подорожало: могут измениться только строки i, для которых ребро
+    // лежит на кратчайшем пути, то есть d[i][u] + old == d[i][v].
+    // Локальный ремонт строк опирается на Дейкстру, поэтому при
+    // отрицательных весах выполняется полный пересчёт
+    if (hasNegative) {
+      recomputeAll();
+      return V;
+    }
+    std::vector<int> affected;
+    for (int i = 0; i < V; ++i) {
+      const int *rowI = dist.row(i);
+      if (rowI[u] != INF && addSaturated(rowI[u], oldWeight) == rowI[v])
+        affected.push_back(i);
+    }
+    const std::vector<int> rowV(dist.row(v), dist.row(v) + V);
+    int workers = std::max(1, std::min<int>(threads, affected.size()));
+    parallelFor(workers, workers, [&](int w) {
+      std::vector<char> inT(V, 0);
+      for (size_t t = w; t < affected.size(); t += workers)
+        repairRow(affected[t], u, oldWeight, rowV, inT);
+    });
+    return static_cast<int>(affected.size());
+  }
+};
+
+// Сравнение инкрементальных обновлений с полным пересчётом: updates
+// изменений весов случайных существующих рёбер (поровну удешевлений и
+// подорожаний)
+void benchmarkUpdates(int V, int updates) {
+  std::vector<std::vector<int>> graph = generateGraph(V, 0.01, 11);
+  DynamicShortestPaths dynamic(graph, 1);
+  std::vector<std::pair<int, int>> edges;
+  for (int u = 0; u < V; ++u) {
+    for (int v = 0; v < V; ++v) {
+      if (u != v && graph[u][v] != INF)
+        edges.push_back({u, v});
+    }
+  }
+  std::mt19937 generator(5);
+  std::uniform_int_distribution<size_t> edge(0, edges.size() - 1);
+  std::uniform_int_distribution<> delta(1, 100);
+
+  long long recomputedRows = 0;
+  auto start = std::chrono::high_resolution_clock::now();
+  for (int t = 0; t < updates; ++t) {
+    std::pair<int, int> e = edges[edge(generator)];
+    int &w = graph[e.first][e.second];
+    w = t % 2 == 0 ? std::max(1, w / 2) : w + delta(generator);
+    recomputedRows += dynamic.setEdge(e.first, e.second, w);
+  }
+  auto end = std::chrono::high_resolution_clock::now();
+  std::chrono::duration<double> incremental = end - start;
+
+  FlatMatrix full(graph);
+  start = std::chrono::high_resolution_clock::now();
+  floydWarshallBlocked(full, 64, 1);
+  end = std::chrono::high_resolution_clock::now();
+  std::chrono::duration<double> recompute = end - start;
+
+  std::cout << "V = " << V << ": " << updates << " обновлений за "
+            << incremental.count() * 1000 << " мс ("
+            << incremental.count() * 1000 / updates
+            << " мс на обновление, пересчитано строк " << recomputedRows
+            << "), полный пересчёт " << recompute.count() * 1000
+            << " мс, совпадение: "
+            << (full.data == dynamic.distances().data ? "успех" : "ошибка")
+            << std::endl;
+}
+
+// Сравнение классического и блочного алгоритмов по времени и результату
+void benchmarkFloyd(int V, int tileSize) {
+  std::vector<std::vector<int>> graph = generateGraph(V, 0.05, 42);
+
+  auto start = std::chrono::high_resolution_clock::now();
+  std::vector<std::vector<int>> expected = shortestDistances(graph);
+  auto end = std::chrono::high_resolution_clock::now();
+  std::chrono::duration<double> classic = end - start;
+
+  FlatMatrix dist(graph);
+  start = std::chrono::high_resolution_clock::now();
+  floydWarshallBlocked(dist, tileSize);
+  end = std::chrono::high_resolution_clock::now();
+  std::chrono::duration<double> blocked = end - start;
+
+  std::cout << "V = " << V << ", плитка " << tileSize
+            << ": классический " << classic.count() * 1000
+            << " мс, блочный " << blocked.count() * 1000
+            << " мс, совпадение: "
+            << (dist.toNested() == expected ? "успех" : "ошибка") << std::endl;
+}
+
+// Сравнение точного ядра с насыщением и векторного ядра в одном потоке
+void benchmarkKernels(int V, int tileSize) {
+  std::vector<std::vector<int>> graph = generateGraph(V, 0.05, 7);
+  const char *name;
+  selectMinPlusKernel(&name);
+
+  FlatMatrix exact(graph);
+  auto start = std::chrono::high_resolution_clock::now();
+  floydWarshallBlocked(exact, tileSize, 1, false);
+  auto end = std::chrono::high_resolution_clock::now();
+  std::chrono::duration<double> exactTime = end - start;
+
+  FlatMatrix vector(graph);
+  start = std::chrono::high_resolution_clock::now();
+  floydWarshallBlocked(vector, tileSize, 1, true);
+  end = std::chrono::high_resolution_clock::now();
+  std::chrono::duration<double> vectorTime = end - start;
+
+  std::cout << "V = " << V << ", один поток: точное ядро "
+            << exactTime.count() * 1000 << " мс, ядро " << name << " "
+            << vectorTime.count() * 1000 << " мс, ускорение "
+            << exactTime.count() / vectorTime.count() << ", совпадение: "
+            << (exact.data == vector.data ? "успех" : "ошибка") << std::endl;
+}
+
+// Кратчайшие пути для графа из файла: время загрузки и вычисления
+// выводится отдельно
+int runFile(const std::string &fileName, bool edgeList,
+            const std::string &saveName) {
+  LoadedGraph graph;
+  auto start = std::chrono::high_resolution_clock::now();
+  if (!loadGraph(fileName, edgeList, graph)) {
+    std::cerr << "Не удалось загрузить граф из " << fileName << std::endl;
+    return 1;
+  }
+  auto end = std::chrono::high_resolution_clock::now();
+  std::chrono::duration<double> loadTime = end - start;
+  int V = graph.dense ? graph.matrix.V : graph.csr.V;
+  std::cout << "Загрузка: " << loadTime.count() * 1000 << " мс, V = " << V
+            << std::endl;
+
+  if (!saveName.empty()) {
+    bool saved;
+    if (graph.dense) {
+      saved = saveMatrixBinary(saveName, graph.matrix);
+    } else {
+      std::vector<Edge> edges;
+      for (int u = 0; u < V; ++u) {
+        for (int e = graph.csr.offsets[u]; e < graph.csr.offsets[u + 1]; ++e)
+          edges.push_back({u, graph.csr.targets[e], graph.csr.weights[e]});
+      }
+      saved = saveEdgesBinary(saveName, V, edges);
+    }
+    std::cout << (saved ? "Сохранено в " : "Не удалось сохранить в ")
+              << saveName << std::endl;
+  }
+
+  start = std::chrono::high_resolution_clock::now();
+  if (graph.dense) {
+    ShortestPaths paths = ShortestPaths::compute(std::move(graph.matrix), false);
+    end = std::chrono::high_resolution_clock::now();
+    if (V <= 20) {
+      std::cout << "Кратчайшие пути между всеми парами вершин:" << std::endl;
+      printMatrix(paths.distanceMatrix());
+    }
+  } else {
+    SparseShortestPaths engine(graph.csr);
+    if (!engine.valid()) {
+      std::cerr << "Граф содержит цикл отрицательного веса" << std::endl;
+      return 1;
+    }
+    std::atomic<long long> checksum{0};
+    engine.allPairs(std::thread::hardware_concurrency(),
+                    [&checksum](int, const std::vector<int> &row) {
+                      long long local = 0;
+                      for (int d : row)
+                        local += d == INF ? 0 : d;
+                      checksum += local;
+                    });
+    end = std::chrono::high_resolution_clock::now();
+    std::cout << "Контрольная сумма расстояний: " << checksum.load() << std::endl;
+  }
+  std::chrono::duration<double> computeTime = end - start;
+  std::cout << "Вычисление: " << computeTime.count() * 1000 << " мс" << std::endl;
+  return 0;
+}
+
+// Использование: 7.2 [файл [--edges] [--save файл.bin]]
+// Без аргументов запускается демонстрация на встроенном графе и замеры
+int main(int argc, char *argv[]) {
+  if (argc > 1) {
+    std::string fileName = argv[1], saveName;
+    bool edgeList = false;
+    for (int i = 2; i < argc; ++i) {
+      std::string option = argv[i];
+      if (option == "--edges") {
+        edgeList = true;
+      } else if (option == "--save" && i + 1 < argc) {
+        saveName = argv[++i];
+      } else {
+        std::cerr << "Использование: " << argv[0]
+                  << " [файл [--edges] [--save файл.bin]]" << std::endl;
+        return 1;
+      }
+    }
+    return runFile(fileName, edgeList, saveName);
   }
 
   // Создаем матрицу смежности графа
@@ -73,5 +1410,89 @@ int main() {
     // Вызов алгоритма Флойда
     floydWarshall(graph_test);
 
+    FlatMatrix blocked(graph_test);
+    floydWarshallBlocked(blocked, 4);
+    std::cout << "Блочный алгоритм: "
+              << (blocked.toNested() == shortestDistances(graph_test) ? "совпадает" : "не совпадает")
+              << std::endl;
+
+    ShortestPaths paths = ShortestPaths::compute(graph_test);
+    std::cout << "Путь из вершины 1 в вершину 6:";
+    for (int v : paths.path(0, 5))
+      std::cout << " " << v + 1;
+    std::cout << " (длина " << paths.distance(0, 5) << ")" << std::endl;
+
+    ShortestPaths loaded;
+    if (paths.save("shortest_paths.bin") && loaded.load("shortest_paths.bin")) {
+      std::cout << "Загружено через mmap, матрица "
+                << (loaded.distanceMatrix() == shortestDistances(graph_test) ? "совпадает" : "не совпадает")
+                << ", путь из 2 в 6:";
+      for (int v : loaded.path(1, 5))
+        std::cout << " " << v + 1;
+      std::cout << std::endl;
+    }
+    std::remove("shortest_paths.bin");
+
+    // Циклы нулевого веса и плитки меньше V: вес каждого восстановленного
+    // пути должен совпадать с расстоянием
+    std::mt19937 zeroRng(7);
+    std::vector<std::vector<int>> zeroCycles(100, std::vector<int>(100, INF));
+    for (int i = 0; i < 100; ++i) {
+      zeroCycles[i][i] = 0;
+      for (int j = 0; j < 100; ++j) {
+        if (i != j && zeroRng() % 10 == 0)
+          zeroCycles[i][j] = static_cast<int>(zeroRng() % 4);
+      }
+    }
+    ShortestPaths zeroPaths = ShortestPaths::compute(zeroCycles, true, 8);
+    bool pathsMatch = zeroPaths.distanceMatrix() == shortestDistances(zeroCycles);
+    for (int u = 0; u < 100; ++u) {
+      for (int v = 0; v < 100; ++v) {
+        if (zeroPaths.distance(u, v) == INF)
+          continue;
+        std::vector<int> route = zeroPaths.path(u, v);
+        long long weight = 0;
+        for (size_t t = 1; t < route.size(); ++t)
+          weight += zeroCycles[route[t - 1]][route[t]];
+        pathsMatch = pathsMatch && !route.empty() &&
+                     weight == zeroPaths.distance(u, v);
+      }
+    }
+    std::cout << "Пути при циклах нулевого веса: "
+              << (pathsMatch ? "совпадают" : "не совпадают") << std::endl;
+
+    CsrGraph csr = CsrGraph::fromMatrix(graph_test);
+    SparseShortestPaths sparse(csr);
+    bool sameRows = true;
+    sparse.allPairs(1, [&](int source, const std::vector<int> &row) {
+      sameRows = sameRows && row == shortestDistances(graph_test)[source];
+    });
+    std::cout << "Дейкстра по CSR: " << (sameRows ? "совпадает" : "не совпадает")
+              << ", расстояния от вершин 2 и 3: ";
+    for (int d : sparse.multiSource({1, 2}))
+      std::cout << (d == INF ? "-" : std::to_string(d)) << " ";
+    std::cout << std::endl;
+
+    // Отрицательные веса: перевзвешивание по Джонсону
+    std::vector<std::vector<int>> negative = graph_test;
+    negative[0][3] = -3;
+    negative[3][4] = -2;
+    CsrGraph negativeCsr = CsrGraph::fromMatrix(negative);
+    SparseShortestPaths johnson(negativeCsr);
+    bool johnsonRows = johnson.valid();
+    johnson.allPairs(1, [&](int source, const std::vector<int> &row) {
+      johnsonRows = johnsonRows && row == shortestDistances(negative)[source];
+    });
+    std::cout << "Джонсон с отрицательными весами: "
+              << (johnsonRows ? "совпадает" : "не совпадает") << std::endl;
+
+    benchmarkSparse(5000, 5);
+    benchmarkUpdates(1000, 100);
+    benchmarkUpdates(2000, 100);
+    benchmarkUpdates(5000, 100);
+    benchmarkKernels(1000, 64);
+    benchmarkFloyd(500, 64);
+    benchmarkFloyd(1000, 64);
+
     return 0;
 }
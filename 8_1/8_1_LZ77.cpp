@@ -1,60 +1,84 @@
+#include <algorithm>
+#include <chrono>
 #include <iostream>
 #include <string>
 #include <vector>
 
-struct LZ77Token {
-  int offset;
-  int length;
-  char nextChar;
-};
+#include "lz77.h"
+#include "sample_text.h"
 
-// Функция декодирования для LZ77
-std::string decodeLZ77(const std::vector<LZ77Token> &tokens) {
-  std::string decoded;
+void benchmarkLZ77(const std::string &name, const std::string &input,
+                   int windowSize, int chainLength, bool lazy,
+                   bool bruteForce = false) {
+  auto start = std::chrono::high_resolution_clock::now();
+  std::vector<LZ77Token> tokens =
+      bruteForce ? encodeLZ77BruteForce(input, windowSize)
+                 : encodeLZ77(input, windowSize, chainLength, lazy);
+  auto end = std::chrono::high_resolution_clock::now();
+  std::chrono::duration<double> time = end - start;
 
-  for (const auto &token : tokens) {
-    if (token.offset == 0 && token.length == 0) {
-      decoded += token.nextChar;
-    } else {
-      int start = static_cast<int>(decoded.size()) - token.offset;
-      for (int i = 0; i < token.length; ++i) {
-        decoded += decoded[start + i];
-      }
-      decoded += token.nextChar;
-    }
-  }
-
-  return decoded;
+  bool ok = decodeLZ77(tokens) == input;
+  double megabytes = input.size() / (1024.0 * 1024.0);
+  std::cout << name << ", окно " << windowSize;
+  if (bruteForce)
+    std::cout << ", перебор";
+  else
+    std::cout << ", цепочка " << chainLength << (lazy ? ", ленивый" : "");
+  std::cout << ": " << tokens.size() << " токенов, "
+            << megabytes / time.count() << " МБ/с, восстановление "
+            << (ok ? "успешно" : "не удалось") << std::endl;
 }
 
-std::vector<LZ77Token> encodeLZ77(const std::string &input, int windowSize) {
-  std::vector<LZ77Token> tokens;
-  int i = 0;
-
-  while (i < input.length()) {
-    int matchLength = 0;
-    int matchOffset = 0;
-    char nextChar = input[i];
+// Размеры двоичного формата и скорость его распаковки
+void benchmarkFormat(const std::string &name, const std::string &input,
+                     int windowSize, int chainLength, bool lazy) {
+  std::vector<LZ77Token> tokens =
+      encodeLZ77(input, windowSize, chainLength, lazy);
+  double megabytes = input.size() / (1024.0 * 1024.0);
+  std::cout << name << ": " << input.size() << " байт, токенами "
+            << tokens.size() * sizeof(LZ77Token) << " байт" << std::endl;
 
-    // Поиск самой длинной совпадающей подстроки в пределах окна
-    for (int j = std::max(0, i - windowSize); j < i; ++j) {
-      int length = 0;
-      while (i + length < input.length() &&
-             input[j + length] == input[i + length])
-        length++;
+  for (bool entropy : {false, true}) {
+    std::vector<uint8_t> packed = packLZ77(tokens, entropy);
+    const int repeats = 5;
+    std::string decoded;
+    bool ok = true;
+    auto start = std::chrono::high_resolution_clock::now();
+    for (int r = 0; r < repeats; ++r)
+      ok = ok && unpackLZ77(packed, decoded);
+    auto end = std::chrono::high_resolution_clock::now();
+    std::chrono::duration<double> time = end - start;
+    ok = ok && decoded == input;
+    std::cout << (entropy ? "  varint и Хаффман: " : "  varint: ")
+              << packed.size() << " байт ("
+              << 100.0 * packed.size() / std::max<size_t>(input.size(), 1)
+              << "%), распаковка " << megabytes * repeats / time.count()
+              << " МБ/с, восстановление " << (ok ? "успешно" : "не удалось")
+              << std::endl;
+  }
+}
 
-      if (length > matchLength) {
-        matchLength = length;
-        matchOffset = i - j;
-        nextChar = input[i + matchLength];
-      }
-    }
+void benchmarkLZ77() {
+  // Перебор медленный, поэтому сравнение с ним идёт на небольшом входе
+  std::string small = generateText(64 << 10, 1);
+  benchmarkLZ77("Текст 64 КБ", small, 8192, 0, false, true);
+  benchmarkLZ77("Текст 64 КБ", small, 8192, 64, false);
 
-    tokens.push_back({matchOffset, matchLength, nextChar});
-    i += matchLength + 1;
+  std::string text = generateText(8 << 20, 2);
+  for (int window : {32 << 10, 1 << 20}) {
+    for (int chain : {4, 16, 64})
+      benchmarkLZ77("Текст 8 МБ", text, window, chain, false);
+    benchmarkLZ77("Текст 8 МБ", text, window, 16, true);
   }
 
-  return tokens;
+  std::string repetitive;
+  while (repetitive.size() < (8u << 20))
+    repetitive += "0010100110010000001";
+  benchmarkLZ77("Повторы 8 МБ", repetitive, 32 << 10, 64, true);
+
+  benchmarkFormat("Текст 8 МБ, окно 32 КБ", text, 32 << 10, 16, false);
+  benchmarkFormat("Текст 8 МБ, окно 1 МБ", text, 1 << 20, 16, false);
+  benchmarkFormat("Повторы 8 МБ", repetitive, 32 << 10, 64, false);
 }
 
 int main() {
@@ -74,5 +98,7 @@ int main() {
   std::cout << "Восстановленная строка: " << decoded << std::endl;
     std::cout << "Сходство: "<< (input==decoded?"успех":"ошибка")<< std::endl;
 
+    benchmarkLZ77();
+
     return 0;
 }
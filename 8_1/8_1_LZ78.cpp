@@ -1,56 +1,54 @@
+#include <algorithm>
+#include <chrono>
 #include <iostream>
-#include <unordered_map>
+#include <string>
 #include <vector>
 
-struct LZ78Token {
-  uint8_t index;
-  char nextChar;
-};
-
-// Функция кодирования LZ78
-std::vector<LZ78Token> encodeLZ78(const std::string &input) {
-  std::unordered_map<std::string, uint8_t> dictionary;
-  std::vector<LZ78Token> tokens;
-
-  std::string current;
-  int dictIndex = 1;
-
-  for (char c : input) {
-    current += c;
-
-    if (dictionary.find(current) == dictionary.end()) {
-      // Добавляем токен в список
-      dictionary[current] = dictIndex++;
-      // Если текущая строка имеет размер больше 1, мы берем подстроку без
-      // последнего символа
-      tokens.push_back({dictionary[current.substr(0, current.size() - 1)], c});
-      current = "";
+#include "lz78.h"
+#include "sample_text.h"
+
+void benchmarkLZ78(const std::string &text) {
+  double megabytes = text.size() / (1024.0 * 1024.0);
+
+  auto start = std::chrono::high_resolution_clock::now();
+  std::vector<LZ78Token> tokens = encodeLZ78(text);
+  auto end = std::chrono::high_resolution_clock::now();
+  std::chrono::duration<double> encodeTime = end - start;
+  start = std::chrono::high_resolution_clock::now();
+  bool ok = decodeLZ78(tokens) == text;
+  end = std::chrono::high_resolution_clock::now();
+  std::chrono::duration<double> decodeTime = end - start;
+  std::cout << "LZ78, " << megabytes << " МБ: " << tokens.size()
+            << " токенов, кодирование " << megabytes / encodeTime.count()
+            << " МБ/с, декодирование " << megabytes / decodeTime.count()
+            << " МБ/с, восстановление " << (ok ? "успешно" : "не удалось")
+            << std::endl;
+
+  const uint8_t *data = reinterpret_cast<const uint8_t *>(text.data());
+  for (int maxBits : {12, 16, 20}) {
+    for (DictionaryPolicy policy :
+         {DictionaryPolicy::Reset, DictionaryPolicy::Freeze}) {
+      start = std::chrono::high_resolution_clock::now();
+      std::vector<uint8_t> packed =
+          lzwCompress(data, text.size(), maxBits, policy);
+      end = std::chrono::high_resolution_clock::now();
+      encodeTime = end - start;
+      std::vector<uint8_t> restored;
+      start = std::chrono::high_resolution_clock::now();
+      ok = lzwDecompress(packed, restored);
+      end = std::chrono::high_resolution_clock::now();
+      decodeTime = end - start;
+      ok = ok && std::equal(restored.begin(), restored.end(), data) &&
+           restored.size() == text.size();
+      std::cout << "LZW, до " << maxBits << " бит, "
+                << (policy == DictionaryPolicy::Reset ? "сброс" : "заморозка")
+                << ": " << packed.size() << " байт ("
+                << 100.0 * packed.size() / text.size() << "%), сжатие "
+                << megabytes / encodeTime.count() << " МБ/с, распаковка "
+                << megabytes / decodeTime.count() << " МБ/с, восстановление "
+                << (ok ? "успешно" : "не удалось") << std::endl;
     }
   }
-
-  // Если после цикла осталась непустая часть строки, добавляем её в токены
-  if (!current.empty()) {
-    tokens.push_back(
-        {dictionary[current.substr(0, current.size() - 1)], current.back()});
-  }
-
-  return tokens;
-}
-
-// Функция декодирования LZ78
-std::string decodeLZ78(const std::vector<LZ78Token> &tokens) {
-  std::unordered_map<uint8_t, std::string> dictionary;
-  std::string decoded;
-  int dictIndex = 1;
-
-  for (const auto &token : tokens) {
-    std::string entry = (token.index > 0) ? dictionary[token.index] : "";
-    entry += token.nextChar;
-    decoded += entry;
-    dictionary[dictIndex++] = entry;
-  }
-
-  return decoded;
 }
 
 int main() {
@@ -61,8 +59,8 @@ int main() {
   // Вывод закодированных данных
   std::cout << "LZ78 кодирование:" << std::endl;
   for (const auto &token : tokens) {
-    std::cout << "(" << static_cast<int>(token.index) << ", " << token.nextChar
-              << ")" << std::endl;
+    std::cout << "(" << token.index << ", " << token.nextChar << ")"
+              << std::endl;
   }
 
   // Декодирование
@@ -72,5 +70,7 @@ int main() {
     std::cout << "Восстановленная строка: " << decoded << std::endl;
     std::cout << "Сходство: " << (input == decoded ? "успех" : "ошибка") << std::endl;
 
+    benchmarkLZ78(generateText(8 << 20, 1));
+
     return 0;
 }
@@ -0,0 +1,340 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <new>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <dirent.h>
+
+#include "compress.h"
+#include "sample_text.h"
+
+// Учёт памяти кучи: операторы new и delete заменены счётчиками. Перед
+// блоком лежит его размер, поэтому освобождение тоже учитывается. Пик
+// сбрасывается перед каждым замером и считается от текущего объёма
+namespace memory {
+size_t current = 0;
+size_t peak = 0;
+
+void reset() { peak = current; }
+} // namespace memory
+
+const size_t ALLOCATION_HEADER = 16; // Сохраняет выравнивание блока
+
+// Не встраиваются: иначе компилятор видит free для указателя из new и
+// смещение заголовка перед массивом и выдаёт ложные предупреждения
+__attribute__((noinline)) void *trackedAllocate(size_t size) {
+  void *block = std::malloc(size + ALLOCATION_HEADER);
+  if (!block)
+    return nullptr;
+  *static_cast<size_t *>(block) = size;
+  memory::current += size;
+  memory::peak = std::max(memory::peak, memory::current);
+  return static_cast<char *>(block) + ALLOCATION_HEADER;
+}
+
+__attribute__((noinline)) void trackedFree(void *pointer) {
+  if (!pointer)
+    return;
+  void *block = static_cast<char *>(pointer) - ALLOCATION_HEADER;
+  memory::current -= *static_cast<size_t *>(block);
+  std::free(block);
+}
+
+void *operator new(size_t size) {
+  void *pointer = trackedAllocate(size);
+  if (!pointer)
+    throw std::bad_alloc();
+  return pointer;
+}
+void *operator new[](size_t size) { return operator new(size); }
+void *operator new(size_t size, const std::nothrow_t &) noexcept {
+  return trackedAllocate(size);
+}
+void *operator new[](size_t size, const std::nothrow_t &) noexcept {
+  return trackedAllocate(size);
+}
+void operator delete(void *pointer) noexcept { trackedFree(pointer); }
+void operator delete[](void *pointer) noexcept { trackedFree(pointer); }
+void operator delete(void *pointer, size_t) noexcept { trackedFree(pointer); }
+void operator delete[](void *pointer, size_t) noexcept { trackedFree(pointer); }
+
+struct CorpusEntry {
+  std::string name;
+  std::vector<uint8_t> data;
+};
+
+// Строки журнала по нескольким шаблонам: много длинных повторов, меняются
+// только время и числа
+std::vector<uint8_t> generateLog(size_t size, unsigned seed) {
+  static const char *templates[] = {
+      "INFO  request served path=/api/v1/cities status=200 bytes=",
+      "INFO  request served path=/api/v1/graph status=200 bytes=",
+      "WARN  slow query table=city_data elapsed_ms=",
+      "ERROR connection reset by peer retry=",
+  };
+  std::mt19937 rng(seed);
+  std::vector<uint8_t> log;
+  log.reserve(size + 128);
+  uint64_t time = 1700000000000ull;
+  while (log.size() < size) {
+    time += rng() % 50;
+    std::string line = std::to_string(time) + " " + templates[rng() % 4] +
+                       std::to_string(rng() % 5000) + "\n";
+    log.insert(log.end(), line.begin(), line.end());
+  }
+  log.resize(size);
+  return log;
+}
+
+bool readFile(const std::string &fileName, std::vector<uint8_t> &data) {
+  std::ifstream file(fileName, std::ios::binary);
+  if (!file)
+    return false;
+  data.assign(std::istreambuf_iterator<char>(file),
+              std::istreambuf_iterator<char>());
+  return true;
+}
+
+// Исходники репозитория: все .cpp и .h из каталогов заданий, по алфавиту
+bool readSources(const std::string &root, std::vector<uint8_t> &data) {
+  data.clear();
+  for (const char *directory :
+       {"5_2", "6_1", "6_2", "7_1", "7_2", "8_1", "8_2"}) {
+    std::string path = root + "/" + directory;
+    DIR *dir = opendir(path.c_str());
+    if (!dir)
+      continue;
+    std::vector<std::string> names;
+    while (dirent *entry = readdir(dir)) {
+      std::string name = entry->d_name;
+      size_t dot = name.rfind('.');
+      if (dot != std::string::npos &&
+          (name.substr(dot) == ".cpp" || name.substr(dot) == ".h"))
+        names.push_back(name);
+    }
+    closedir(dir);
+    std::sort(names.begin(), names.end());
+    for (const std::string &name : names) {
+      std::vector<uint8_t> file;
+      if (readFile(path + "/" + name, file))
+        data.insert(data.end(), file.begin(), file.end());
+    }
+  }
+  return !data.empty();
+}
+
+// Корпус: случайный текст, дамп городов из 5_2, исходники, журнал.
+// root — корень репозитория; чего нет на диске, пропускается
+std::vector<CorpusEntry> buildCorpus(const std::string &root, size_t size) {
+  std::vector<CorpusEntry> corpus;
+  std::string text = generateText(size, 1);
+  corpus.push_back({"text", std::vector<uint8_t>(text.begin(), text.end())});
+  CorpusEntry city{"city", {}};
+  if (readFile(root + "/5_2/city_data.bin", city.data) && !city.data.empty())
+    corpus.push_back(city);
+  else
+    std::cerr << "Нет " << root << "/5_2/city_data.bin, пропущен" << std::endl;
+  CorpusEntry source{"source", {}};
+  if (readSources(root, source.data))
+    corpus.push_back(source);
+  else
+    std::cerr << "Нет исходников в " << root << ", пропущены" << std::endl;
+  corpus.push_back({"log", generateLog(size, 2)});
+  return corpus;
+}
+
+struct BenchmarkResult {
+  std::string corpus;
+  std::string codec;
+  size_t inputSize;
+  size_t packedSize;
+  double compressSpeed;   // МБ/с
+  double decompressSpeed; // МБ/с, лучший из повторов
+  size_t compressMemory;  // Пик кучи сверх входа, байт
+  size_t decompressMemory;
+  bool roundTrip;
+};
+
+// Один кодек на всём входе как на одном блоке контейнера
+BenchmarkResult runCodec(const CorpusEntry &entry, Codec codec) {
+  BenchmarkResult result;
+  result.corpus = entry.name;
+  result.codec = codecName(codec);
+  result.inputSize = entry.data.size();
+  double megabytes = entry.data.size() / (1024.0 * 1024.0);
+
+  std::vector<uint8_t> packed;
+  memory::reset();
+  size_t base = memory::current;
+  auto start = std::chrono::high_resolution_clock::now();
+  Codec chosen = codec;
+  if (codec == Codec::Auto)
+    chosen = compressBlock(codec, entry.data.data(), entry.data.size(), packed);
+  else
+    packed = encodeWith(codec, entry.data.data(), entry.data.size());
+  auto end = std::chrono::high_resolution_clock::now();
+  std::chrono::duration<double> time = end - start;
+  result.compressSpeed = megabytes / time.count();
+  result.compressMemory = memory::peak - base;
+  result.packedSize = packed.size();
+
+  const int repeats = 3;
+  result.roundTrip = true;
+  result.decompressSpeed = 0;
+  result.decompressMemory = 0;
+  for (int r = 0; r < repeats; ++r) {
+    std::vector<uint8_t> restored;
+    memory::reset();
+    base = memory::current;
+    start = std::chrono::high_resolution_clock::now();
+    bool ok = decompressBlock(chosen, packed.data(), packed.size(),
+                              entry.data.size(), restored);
+    end = std::chrono::high_resolution_clock::now();
+    time = end - start;
+    result.decompressSpeed =
+        std::max(result.decompressSpeed, megabytes / time.count());
+    result.decompressMemory =
+        std::max(result.decompressMemory, memory::peak - base);
+    result.roundTrip = result.roundTrip && ok && restored == entry.data;
+  }
+  return result;
+}
+
+double ratio(const BenchmarkResult &result) {
+  return 100.0 * result.packedSize / std::max<size_t>(result.inputSize, 1);
+}
+
+void printTable(const std::vector<BenchmarkResult> &results,
+                std::ostream &out) {
+  char line[160];
+  std::snprintf(line, sizeof(line),
+                "%-8s %-13s %10s %10s %8s %10s %10s %9s %9s %s", "corpus",
+                "codec", "input", "packed", "ratio%", "comp MB/s", "dec MB/s",
+                "comp MB", "dec MB", "ok");
+  out << line << std::endl;
+  for (const BenchmarkResult &r : results) {
+    std::snprintf(line, sizeof(line),
+                  "%-8s %-13s %10zu %10zu %8.2f %10.1f %10.1f %9.2f %9.2f %s",
+                  r.corpus.c_str(), r.codec.c_str(), r.inputSize, r.packedSize,
+                  ratio(r), r.compressSpeed, r.decompressSpeed,
+                  r.compressMemory / (1024.0 * 1024.0),
+                  r.decompressMemory / (1024.0 * 1024.0),
+                  r.roundTrip ? "yes" : "NO");
+    out << line << std::endl;
+  }
+}
+
+void printCsv(const std::vector<BenchmarkResult> &results, std::ostream &out) {
+  out << "corpus,codec,input_bytes,packed_bytes,ratio_percent,"
+         "compress_mb_s,decompress_mb_s,compress_peak_bytes,"
+         "decompress_peak_bytes,round_trip"
+      << std::endl;
+  for (const BenchmarkResult &r : results) {
+    out << r.corpus << "," << r.codec << "," << r.inputSize << ","
+        << r.packedSize << "," << ratio(r) << "," << r.compressSpeed << ","
+        << r.decompressSpeed << "," << r.compressMemory << ","
+        << r.decompressMemory << "," << (r.roundTrip ? "true" : "false")
+        << std::endl;
+  }
+}
+
+void printJson(const std::vector<BenchmarkResult> &results,
+               std::ostream &out) {
+  out << "[" << std::endl;
+  for (size_t i = 0; i < results.size(); ++i) {
+    const BenchmarkResult &r = results[i];
+    out << "  {\"corpus\": \"" << r.corpus << "\", \"codec\": \"" << r.codec
+        << "\", \"input_bytes\": " << r.inputSize
+        << ", \"packed_bytes\": " << r.packedSize
+        << ", \"ratio_percent\": " << ratio(r)
+        << ", \"compress_mb_s\": " << r.compressSpeed
+        << ", \"decompress_mb_s\": " << r.decompressSpeed
+        << ", \"compress_peak_bytes\": " << r.compressMemory
+        << ", \"decompress_peak_bytes\": " << r.decompressMemory
+        << ", \"round_trip\": " << (r.roundTrip ? "true" : "false") << "}"
+        << (i + 1 < results.size() ? "," : "") << std::endl;
+  }
+  out << "]" << std::endl;
+}
+
+void printUsage(const char *program) {
+  std::cerr << "Использование: " << program
+            << " [--csv | --json] [--out файл] [--root корень_репозитория]"
+               " [--size МБ] [--codec кодек]\n"
+            << "По умолчанию корень \"..\" (запуск из каталога сборки), "
+               "размер синтетических входов 8 МБ, все кодеки"
+            << std::endl;
+}
+
+int main(int argc, char *argv[]) {
+  std::string format = "table", outName, root = "..";
+  size_t size = 8 << 20;
+  std::vector<Codec> codecs = {Codec::Huffman, Codec::ShannonFano,
+                               Codec::TANS,    Codec::LZ77,
+                               Codec::LZW,     Codec::Auto};
+  for (int i = 1; i < argc; ++i) {
+    std::string option = argv[i];
+    if (option == "--csv" || option == "--json") {
+      format = option.substr(2);
+    } else if (option == "--out" && i + 1 < argc) {
+      outName = argv[++i];
+    } else if (option == "--root" && i + 1 < argc) {
+      root = argv[++i];
+    } else if (option == "--size" && i + 1 < argc) {
+      long megabytes = std::strtol(argv[++i], nullptr, 10);
+      if (megabytes <= 0 || megabytes > 64) {
+        std::cerr << "Размер от 1 до 64 МБ" << std::endl;
+        return 1;
+      }
+      size = static_cast<size_t>(megabytes) << 20;
+    } else if (option == "--codec" && i + 1 < argc) {
+      Codec codec;
+      if (!parseCodec(argv[++i], codec) || codec == Codec::Stored) {
+        std::cerr << "Неизвестный кодек: " << argv[i] << std::endl;
+        return 1;
+      }
+      codecs = {codec};
+    } else {
+      printUsage(argv[0]);
+      return 1;
+    }
+  }
+
+  std::vector<CorpusEntry> corpus = buildCorpus(root, size);
+  std::vector<BenchmarkResult> results;
+  bool allOk = true;
+  for (const CorpusEntry &entry : corpus) {
+    for (Codec codec : codecs) {
+      results.push_back(runCodec(entry, codec));
+      allOk = allOk && results.back().roundTrip;
+      // Ход замеров виден, даже если вывод идёт в файл
+      std::cerr << entry.name << " " << codecName(codec) << ": "
+                << ratio(results.back()) << "%" << std::endl;
+    }
+  }
+
+  std::ofstream file;
+  if (!outName.empty()) {
+    file.open(outName);
+    if (!file) {
+      std::cerr << "Не удалось создать " << outName << std::endl;
+      return 1;
+    }
+  }
+  std::ostream &out = outName.empty() ? std::cout : file;
+  if (format == "csv")
+    printCsv(results, out);
+  else if (format == "json")
+    printJson(results, out);
+  else
+    printTable(results, out);
+
+  // Ненулевой код выхода, если хоть один кодек не восстановил вход
+  return allOk ? 0 : 1;
+}
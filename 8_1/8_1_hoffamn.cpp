@@ -1,112 +1,83 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
 #include <iostream>
-#include <queue>
+#include <iterator>
+#include <random>
 #include <string>
 #include <unordered_map>
 #include <vector>
 
-struct Node {
-  char character;
-  int frequency;
-  Node *left;
-  Node *right;
-
-  Node(char c, int f)
-      : character(c), frequency(f), left(nullptr), right(nullptr) {}
-};
-
-// Сравнение узлов для очереди с приоритетом
-struct Compare {
-  bool operator()(Node *l, Node *r) { return l->frequency > r->frequency; }
-};
-
-// Построение дерева Хаффмана
-Node *buildHuffmanTree(const std::string &text) {
-  // Подсчёт частот
-  std::unordered_map<char, int> freq;
-  for (char c : text) {
-    freq[c]++;
-  }
-
-  // Создание очереди с приоритетом
-  std::priority_queue<Node *, std::vector<Node *>, Compare> pq;
-  for (const auto &pair : freq) {
-    pq.push(new Node(pair.first, pair.second));
-  }
-
-  // Построение дерева
-  while (pq.size() > 1) {
-    Node *left = pq.top();
-    pq.pop();
-    Node *right = pq.top();
-    pq.pop();
-
-    Node *parent = new Node('\0', left->frequency + right->frequency);
-    parent->left = left;
-    parent->right = right;
-
-    pq.push(parent);
-  }
-
-  return pq.top();
-}
+#include "huffman.h"
 
-// Генерация кодов Хаффмана
-void generateHuffmanCodes(Node *root,
-                          std::unordered_map<char, std::string> &codes,
-                          const std::string &code) {
-  if (!root)
+// Генерация кодов Хаффмана строками из '0' и '1'. Единственный символ
+// получает код "0", чтобы его можно было записать
+void generateHuffmanCodes(const HuffmanTree &tree, std::string codes[256]) {
+  for (int s = 0; s < 256; ++s)
+    codes[s].clear();
+  if (tree.size == 0)
     return;
-
-  if (!root->left && !root->right) {
-    codes[root->character] = code;
-  }
-
-  generateHuffmanCodes(root->left, codes, code + "0");
-  generateHuffmanCodes(root->right, codes, code + "1");
-}
-
-// Освобождение памяти дерева
-void freeTree(Node *root) {
-  if (!root)
+  if (tree.size == 1) {
+    codes[tree.nodes[0].character] = "0";
     return;
+  }
 
-  freeTree(root->left);
-  freeTree(root->right);
-  delete root;
+  std::vector<std::pair<int, std::string>> stack = {{tree.root(), ""}};
+  while (!stack.empty()) {
+    int index = stack.back().first;
+    std::string code = std::move(stack.back().second);
+    stack.pop_back();
+    const Node &node = tree.nodes[index];
+    if (node.left < 0) {
+      codes[node.character] = code;
+    } else {
+      stack.push_back({node.left, code + "0"});
+      stack.push_back({node.right, code + "1"});
+    }
+  }
 }
 
 // Функция декодирования
-std::string decodeHuffman(const std::string &encoded, Node *root) {
+std::string decodeHuffman(const std::string &encoded, const HuffmanTree &tree) {
   std::string decoded;
-  Node *current = root;
+  if (tree.size == 0)
+    return decoded;
+  int current = tree.root();
   for (char bit : encoded) {
-    if (bit == '0')
-      current = current->left;
-    else
-      current = current->right;
-
-    if (!current->left && !current->right) {
-      decoded += current->character;
-      current = root;
+    if (tree.nodes[current].left >= 0)
+      current = bit == '0' ? tree.nodes[current].left : tree.nodes[current].right;
+
+    if (tree.nodes[current].left < 0) {
+      decoded += static_cast<char>(tree.nodes[current].character);
+      current = tree.root();
     }
   }
   return decoded;
 }
 
+
 void testHuffman(const std::string &input, bool debug = false) {
   std::cout << "Задана строка: " << input << std::endl;
 
-  // Построение дерева Хаффмана
-  Node *root = buildHuffmanTree(input);
+  // Построение дерева Хаффмана по байтам строки
+  const uint8_t *bytes = reinterpret_cast<const uint8_t *>(input.data());
+  uint32_t freq[256];
+  countFrequencies(bytes, input.size(), freq);
+  HuffmanTree tree;
+  buildHuffmanTree(freq, tree);
 
   // Генерация кодов
-  std::unordered_map<char, std::string> codes;
-  generateHuffmanCodes(root, codes, "");
+  std::string codes[256];
+  generateHuffmanCodes(tree, codes);
 
   // Кодирование строки
   std::string encoded;
-  for (char c : input) {
-    encoded += codes[c];
+  for (size_t i = 0; i < input.size(); ++i) {
+    encoded += codes[bytes[i]];
   }
 
   // Расчет размеров
@@ -121,15 +92,23 @@ void testHuffman(const std::string &input, bool debug = false) {
   std::cout << "Коэффициент сжатия: " << compressionRatio << "%" << std::endl;
 
   if (debug) {
-    // Вывод кодов символов
-    std::cout << "\nКоды символов:" << std::endl;
-    for (const auto &code : codes) {
-      std::cout << "'" << code.first << "' : " << code.second << std::endl;
+    // Вывод кодов байтов. Буква кириллицы в UTF-8 занимает два байта,
+    // поэтому непечатные байты выводятся шестнадцатеричными
+    std::cout << "\nКоды байтов:" << std::endl;
+    for (int s = 0; s < 256; ++s) {
+      if (codes[s].empty())
+        continue;
+      char name[8];
+      if (s >= 0x20 && s < 0x7F)
+        std::snprintf(name, sizeof(name), "'%c'", s);
+      else
+        std::snprintf(name, sizeof(name), "0x%02X", s);
+      std::cout << name << " : " << codes[s] << std::endl;
     }
   }
 
   // Декодирование строки
-  std::string decoded = decodeHuffman(encoded, root);
+  std::string decoded = decodeHuffman(encoded, tree);
 
   std::cout << "\nВосстановленная строка: " << decoded << std::endl;
 
@@ -140,14 +119,167 @@ void testHuffman(const std::string &input, bool debug = false) {
         std::cout << "Декодирование не удалось." << std::endl;
     }
 
-    // Освобождение памяти
-    freeTree(root);
+    // Канонический код с настоящей упаковкой в байты
+    std::vector<uint8_t> packed = huffmanCompress(
+        reinterpret_cast<const uint8_t *>(input.data()), input.size());
+    std::vector<uint8_t> restored;
+    bool restoredOk = huffmanDecompress(packed, restored) &&
+                      std::string(restored.begin(), restored.end()) == input;
+    std::cout << "Канонический код: " << packed.size() << " байт (заголовок "
+              << HUFFMAN_HEADER << " байт), восстановление "
+              << (restoredOk ? "успешно." : "не удалось.") << std::endl;
 }
 
-int main() {
+// Замер построения кода: подсчёт частот и построение дерева с длинами
+void benchmarkConstruction(const std::vector<uint8_t> &data, int builds) {
+  auto start = std::chrono::high_resolution_clock::now();
+  std::unordered_map<char, int> mapFreq;
+  for (uint8_t c : data)
+    mapFreq[static_cast<char>(c)]++;
+  auto end = std::chrono::high_resolution_clock::now();
+  std::chrono::duration<double> mapTime = end - start;
+
+  start = std::chrono::high_resolution_clock::now();
+  uint32_t freq[256];
+  countFrequencies(data.data(), data.size(), freq);
+  end = std::chrono::high_resolution_clock::now();
+  std::chrono::duration<double> arrayTime = end - start;
+
+  bool same = true;
+  for (int s = 0; s < 256; ++s) {
+    auto it = mapFreq.find(static_cast<char>(s));
+    same = same && freq[s] == (it == mapFreq.end() ? 0u : static_cast<uint32_t>(it->second));
+  }
+
+  start = std::chrono::high_resolution_clock::now();
+  uint8_t lengths[256];
+  unsigned checksum = 0;
+  for (int b = 0; b < builds; ++b) {
+    freq[b & 255]++; // Частоты слегка меняются, чтобы сборки различались
+    buildCodeLengths(freq, lengths);
+    checksum += lengths[b & 255];
+  }
+  end = std::chrono::high_resolution_clock::now();
+  std::chrono::duration<double> buildTime = end - start;
+
+  double megabytes = data.size() / (1024.0 * 1024.0);
+  std::cout << "Подсчёт частот: unordered_map " << megabytes / mapTime.count()
+            << " МБ/с, массив " << megabytes / arrayTime.count()
+            << " МБ/с, совпадение: " << (same ? "успех" : "ошибка") << std::endl;
+  std::cout << "Построение дерева и длин кодов: "
+            << buildTime.count() * 1e9 / builds << " нс (контрольная сумма "
+            << checksum << ")" << std::endl;
+}
+
+// Замер сжатия и распаковки канонического кода на входе в несколько мегабайт
+void benchmarkHuffman(const std::string &name, const std::vector<uint8_t> &data,
+                      bool compareStrings = false) {
+  auto start = std::chrono::high_resolution_clock::now();
+  std::vector<uint8_t> packed = huffmanCompress(data.data(), data.size());
+  auto end = std::chrono::high_resolution_clock::now();
+  std::chrono::duration<double> compressTime = end - start;
+
+  std::vector<uint8_t> restored;
+  start = std::chrono::high_resolution_clock::now();
+  bool ok = huffmanDecompress(packed, restored);
+  end = std::chrono::high_resolution_clock::now();
+  std::chrono::duration<double> decompressTime = end - start;
+  ok = ok && restored == data;
+
+  double megabytes = data.size() / (1024.0 * 1024.0);
+  std::cout << name << ", " << megabytes << " МБ: " << packed.size()
+            << " байт (" << 100.0 * packed.size() / std::max<size_t>(data.size(), 1)
+            << "%), сжатие " << megabytes / compressTime.count()
+            << " МБ/с, распаковка " << megabytes / decompressTime.count()
+            << " МБ/с, восстановление " << (ok ? "успешно" : "не удалось")
+            << std::endl;
+
+  if (compareStrings) {
+    // Прежний вариант: код строкой из '0' и '1', обход дерева по битам
+    start = std::chrono::high_resolution_clock::now();
+    uint32_t freq[256];
+    countFrequencies(data.data(), data.size(), freq);
+    HuffmanTree tree;
+    buildHuffmanTree(freq, tree);
+    std::string codes[256];
+    generateHuffmanCodes(tree, codes);
+    std::string encoded;
+    for (uint8_t c : data)
+      encoded += codes[c];
+    end = std::chrono::high_resolution_clock::now();
+    compressTime = end - start;
+    start = std::chrono::high_resolution_clock::now();
+    std::string decoded = decodeHuffman(encoded, tree);
+    end = std::chrono::high_resolution_clock::now();
+    decompressTime = end - start;
+    std::cout << "  строковый вариант: " << encoded.size()
+              << " байт на биты, сжатие " << megabytes / compressTime.count()
+              << " МБ/с, распаковка " << megabytes / decompressTime.count()
+              << " МБ/с" << std::endl;
+  }
+}
+
+void benchmarkHuffman(size_t size) {
+  std::mt19937 rng(42);
+
+  // Текст с неравномерными частотами: вероятность буквы убывает геометрически
+  std::vector<double> weights;
+  for (int k = 0; k < 64; ++k)
+    weights.push_back(std::pow(0.9, k));
+  std::discrete_distribution<int> letter(weights.begin(), weights.end());
+  std::vector<uint8_t> text(size);
+  for (auto &c : text)
+    c = static_cast<uint8_t>(' ' + letter(rng));
+  benchmarkHuffman("Текст", text, true);
+  benchmarkConstruction(text, 100000);
+
+  std::vector<uint8_t> random(size);
+  for (auto &c : random)
+    c = static_cast<uint8_t>(rng());
+  benchmarkHuffman("Случайные байты", random);
+
+  // Частоты Фибоначчи дают дерево глубиной больше MAX_CODE_LENGTH
+  std::vector<uint8_t> skewed;
+  uint64_t a = 1, b = 1;
+  for (int k = 0; k < 30 && skewed.size() < size; ++k) {
+    skewed.insert(skewed.end(), a, static_cast<uint8_t>(k));
+    uint64_t next = a + b;
+    a = b;
+    b = next;
+  }
+  std::shuffle(skewed.begin(), skewed.end(), rng);
+  benchmarkHuffman("Частоты Фибоначчи", skewed);
+}
+
+// Сжатие и восстановление файла целиком в памяти
+bool testFile(const std::string &fileName) {
+  std::ifstream in(fileName, std::ios::binary);
+  if (!in) {
+    std::cout << "Не удалось открыть " << fileName << std::endl;
+    return false;
+  }
+  std::vector<uint8_t> data((std::istreambuf_iterator<char>(in)),
+                            std::istreambuf_iterator<char>());
+  if (data.size() > MAX_ENTROPY_INPUT) {
+    // Счётчики частот 32-битные; большие файлы сжимает siaod-compress блоками
+    std::cout << "Файл длиннее 4 ГБ, сожмите его через siaod-compress"
+              << std::endl;
+    return false;
+  }
+  benchmarkHuffman(fileName, data);
+  return true;
+}
+
+// Использование: 8.1_hoffman [файл]. С файлом проверяется его побайтовое
+// восстановление, без аргументов — демонстрация и замеры
+int main(int argc, char *argv[]) {
+    if (argc > 1)
+      return testFile(argv[1]) ? 0 : 1;
+
     std::string input = "Ана-дэус-рики-паки, Дормы-кормыконсту-таки, Энус-дэус-кана-дэус-БАЦ!";
     std::string input1 = "aboba aboba aboba aboba aboba aboba aboba aboba aboba aboba aboba";
     testHuffman(input, true);
+    benchmarkHuffman(8 << 20);
 
     return 0;
 }
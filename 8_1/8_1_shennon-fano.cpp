@@ -1,112 +1,49 @@
 #include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <fstream>
 #include <iostream>
+#include <random>
 #include <string>
-#include <unordered_map>
 #include <vector>
 
-struct Symbol
-{
-  char character;
-  int frequency;
-};
+#include "shannon_fano.h"
 
-bool compare(const Symbol& a, const Symbol& b)
+// Кодовое слово строкой для вывода. Коды хранятся развёрнутыми: первым
+// в поток уходит младший бит
+std::string codeString(uint16_t code, int length)
 {
-  return a.frequency > b.frequency;
-}
-
-void shannonFano(const std::vector<Symbol>& symbols,
-                 std::unordered_map<char, std::string>& codes, const int start,
-                 const int end, const std::string& code)
-{
-  if (start == end)
-  {
-    codes[symbols[start].character] = code;
-    return;
-  }
-
-  int total = 0;
-  for (int i = start; i <= end; ++i)
-    total += symbols[i].frequency;
-
-  int leftSum = 0;
-  int splitIndex = start;
-
-  // Найдем индекс, при котором деление будет сбалансированным по весам
-  for (int i = start; i < end; ++i)
-  {
-    leftSum += symbols[i].frequency;
-    if (leftSum >= total / 2)
-    {
-      splitIndex = i;
-      break;
-    }
-  }
-
-  shannonFano(symbols, codes, start, splitIndex, code + "0");
-  shannonFano(symbols, codes, splitIndex + 1, end, code + "1");
-}
-
-// Функция восстановления строки
-std::string
-decodeShannonFano(const std::string& encoded,
-                  const std::unordered_map<std::string, char>& reverseCodes)
-{
-  std::string decoded;
-  std::string currentCode;
-
-  for (char c : encoded)
-  {
-    currentCode += c;
-    if (reverseCodes.find(currentCode) != reverseCodes.end())
-    {
-      decoded += reverseCodes.at(currentCode);
-      currentCode = "";
-    }
-  }
-
-  return decoded;
+  std::string bits;
+  for (int i = 0; i < length; ++i)
+    bits += (code >> i & 1) ? '1' : '0';
+  return bits;
 }
 
 void test(const std::string& input, bool debug = false)
 {
   std::cout << "Задана строка: " << input << std::endl;
 
-  // Подсчитаем частоты символов
-  std::unordered_map<char, int> freq;
-  for (char c : input)
-  {
-    freq[c]++;
-  }
-
-  // Создаем вектор символов
-  std::vector<Symbol> symbols;
-  symbols.reserve(freq.size());
-  for (const auto& entry : freq)
-  {
-    symbols.push_back({entry.first, entry.second});
-  }
-
-  // Сортируем символы по частоте
-  std::sort(symbols.begin(), symbols.end(), compare);
-
-  // Генерируем коды
-  std::unordered_map<char, std::string> codes;
-  shannonFano(symbols, codes, 0, symbols.size() - 1, "");
-
-  // Закодируем строку
-  std::string encoded;
-  for (char c : input)
-  {
-    encoded += codes[c];
-  }
+  // Подсчитаем частоты символов и построим коды
+  const uint8_t* data = reinterpret_cast<const uint8_t*>(input.data());
+  uint32_t freq[256];
+  countFrequencies(data, input.size(), freq);
+  CanonicalCode code;
+  buildShannonFanoLengths(freq, code.lengths);
+  assignCanonicalCodes(code);
 
   // Расчет размеров
   size_t originalSize = input.size() * 8; // в битах
-  size_t compressedSize = encoded.size(); // в битах
+  size_t compressedSize = 0;              // в битах
+  for (int s = 0; s < 256; ++s)
+    compressedSize += static_cast<size_t>(freq[s]) * code.lengths[s];
+  std::vector<uint8_t> packed =
+      canonicalCompress(data, input.size(), freq, code.lengths);
 
   std::cout << "Размер до сжатия: " << originalSize << " бит" << std::endl;
-  std::cout << "Размер после сжатия: " << compressedSize << " бит" << std::endl;
+  std::cout << "Размер после сжатия: " << compressedSize << " бит"
+            << std::endl;
+  std::cout << "Упаковано с заголовком: " << packed.size() << " байт"
+            << std::endl;
 
   // Расчет коэффициента сжатия
   double compressionRatio = (double)compressedSize / originalSize * 100;
@@ -114,28 +51,30 @@ void test(const std::string& input, bool debug = false)
 
   if (debug)
   {
-    // Вывод кодов символов
+    // Вывод кодов символов; байты вне ASCII — шестнадцатерично
     std::cout << "\nКоды символов:" << std::endl;
-    for (const auto& code : codes)
+    for (int s = 0; s < 256; ++s)
     {
-      std::cout << "'" << code.first << "' : " << code.second << std::endl;
+      if (!code.lengths[s])
+        continue;
+      if (s >= 32 && s < 127)
+        std::cout << "'" << static_cast<char>(s) << "'";
+      else
+        std::cout << "0x" << std::hex << s << std::dec;
+      std::cout << " : " << codeString(code.codes[s], code.lengths[s])
+                << std::endl;
     }
   }
 
-  // Создаем обратный словарь для декодирования
-  std::unordered_map<std::string, char> reverseCodes;
-  for (const auto& code : codes)
-  {
-    reverseCodes[code.second] = code.first;
-  }
-
-  // Восстанавливаем строку
-  std::string decoded = decodeShannonFano(encoded, reverseCodes);
+  // Восстанавливаем строку общим табличным декодером
+  std::vector<uint8_t> restored;
+  bool ok = huffmanDecompress(packed, restored);
+  std::string decoded(restored.begin(), restored.end());
 
   std::cout << "\nВосстановленная строка: " << decoded << std::endl;
 
   // Проверка корректности восстановления
-  if (input == decoded)
+  if (ok && input == decoded)
   {
     std::cout << "Декодирование успешно." << std::endl;
   }
@@ -145,10 +84,123 @@ void test(const std::string& input, bool debug = false)
   }
 }
 
-int main()
+// Шеннон — Фано и Хаффман на одном входе: размер, скорость, восстановление
+void benchmarkShannonFano(const std::string& name,
+                          const std::vector<uint8_t>& data)
+{
+  double megabytes = data.size() / (1024.0 * 1024.0);
+  std::cout << name << ", " << megabytes << " МБ:" << std::endl;
+  for (bool huffman : {false, true})
+  {
+    auto start = std::chrono::high_resolution_clock::now();
+    std::vector<uint8_t> packed =
+        huffman ? huffmanCompress(data.data(), data.size())
+                : shannonFanoCompress(data.data(), data.size());
+    auto end = std::chrono::high_resolution_clock::now();
+    std::chrono::duration<double> compressTime = end - start;
+
+    std::vector<uint8_t> restored;
+    start = std::chrono::high_resolution_clock::now();
+    bool ok = huffmanDecompress(packed, restored);
+    end = std::chrono::high_resolution_clock::now();
+    std::chrono::duration<double> decompressTime = end - start;
+    ok = ok && restored == data;
+
+    std::cout << (huffman ? "  Хаффман: " : "  Шеннон — Фано: ")
+              << packed.size() << " байт ("
+              << 100.0 * packed.size() / std::max<size_t>(data.size(), 1)
+              << "%), сжатие " << megabytes / compressTime.count()
+              << " МБ/с, распаковка " << megabytes / decompressTime.count()
+              << " МБ/с, восстановление " << (ok ? "успешно" : "не удалось")
+              << std::endl;
+  }
+
+  // Построение длин кодов отдельно: здесь и была квадратичная часть
+  uint32_t freq[256];
+  countFrequencies(data.data(), data.size(), freq);
+  const int builds = 100000;
+  uint8_t lengths[256];
+  unsigned checksum = 0;
+  auto start = std::chrono::high_resolution_clock::now();
+  for (int b = 0; b < builds; ++b)
+  {
+    freq[b & 255]++; // Частоты слегка меняются, чтобы сборки различались
+    buildShannonFanoLengths(freq, lengths);
+    checksum += lengths[b & 255];
+  }
+  auto end = std::chrono::high_resolution_clock::now();
+  std::chrono::duration<double> buildTime = end - start;
+  std::cout << "  построение длин кодов: "
+            << buildTime.count() * 1e9 / builds << " нс (контрольная сумма "
+            << checksum << ")" << std::endl;
+}
+
+void benchmarkShannonFano(size_t size)
+{
+  std::mt19937 rng(42);
+
+  // Текст с неравномерными частотами: вероятность буквы убывает геометрически
+  std::vector<double> weights;
+  for (int k = 0; k < 64; ++k)
+    weights.push_back(std::pow(0.9, k));
+  std::discrete_distribution<int> letter(weights.begin(), weights.end());
+  std::vector<uint8_t> text(size);
+  for (auto& c : text)
+    c = static_cast<uint8_t>(' ' + letter(rng));
+  benchmarkShannonFano("Текст", text);
+
+  std::vector<uint8_t> random(size);
+  for (auto& c : random)
+    c = static_cast<uint8_t>(rng());
+  benchmarkShannonFano("Случайные байты", random);
+
+  // Перекошенные частоты: деление пополам по весу здесь дальше всего от
+  // оптимума, и коды длиннее 15 бит приходится укорачивать
+  std::vector<uint8_t> skewed;
+  uint64_t a = 1, b = 1;
+  for (int k = 0; k < 30 && skewed.size() < size; ++k)
+  {
+    skewed.insert(skewed.end(), a, static_cast<uint8_t>(k));
+    uint64_t next = a + b;
+    a = b;
+    b = next;
+  }
+  std::shuffle(skewed.begin(), skewed.end(), rng);
+  benchmarkShannonFano("Частоты Фибоначчи", skewed);
+}
+
+// Сжатие и восстановление файла целиком в памяти
+bool testFile(const std::string& fileName)
+{
+  std::ifstream in(fileName, std::ios::binary);
+  if (!in)
+  {
+    std::cout << "Не удалось открыть " << fileName << std::endl;
+    return false;
+  }
+  std::vector<uint8_t> data((std::istreambuf_iterator<char>(in)),
+                            std::istreambuf_iterator<char>());
+  if (data.size() > MAX_ENTROPY_INPUT)
+  {
+    // Счётчики частот 32-битные; большие файлы сжимает siaod-compress блоками
+    std::cout << "Файл длиннее 4 ГБ, сожмите его через siaod-compress"
+              << std::endl;
+    return false;
+  }
+  benchmarkShannonFano(fileName, data);
+  return true;
+}
+
+// Использование: 8.1_shennon-fano [файл]. С файлом — сравнение с Хаффманом
+// на нём, без аргументов — демонстрация и замеры
+int main(int argc, char* argv[])
 {
+  if (argc > 1)
+    return testFile(argv[1]) ? 0 : 1;
+
   std::string input = "Ана-дэус-рики-паки, Дормы-кормыконсту-таки, Энус-дэус-кана-дэус-БАЦ!";
   test(input, true);
+  benchmarkShannonFano(8 << 20);
 
   return 0;
 }
@@ -0,0 +1,651 @@
+// Потоковый контейнер над кодеками 8_1. Вход режется на блоки, каждый блок
+// сжимается своим кодеком и пишется кадром с размерами и CRC32, поэтому
+// память ограничена размером блока, а не длиной входа.
+//
+// Формат: "SIAODCZ1", размер блока (4 байта), затем кадры
+//   кодек (1 байт), исходный размер, сжатый размер, CRC32 исходных данных
+//   (по 4 байта, младший первым), сжатые данные.
+// Кадр с исходным размером 0 завершает поток; его данные — индекс блоков
+// для параллельной распаковки файла. Блоки независимы и сжимаются и
+// распаковываются пулом потоков
+#ifndef SIAOD_COMPRESS_H
+#define SIAOD_COMPRESS_H
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <unistd.h>
+
+#include "huffman.h"
+#include "lz77.h"
+#include "lz78.h"
+#include "shannon_fano.h"
+#include "tans.h"
+
+enum class Codec : uint8_t {
+  Stored = 0,
+  Huffman = 1,
+  ShannonFano = 2,
+  LZ77 = 3,  // Токены в varint, оба потока через код Хаффмана
+  LZW = 4,   // Семейство LZ78: у токенов LZ78 нет двоичного формата
+  TANS = 5,  // Табличный ANS: частоты как у Хаффмана, но без округления до бит
+  Auto = 255 // Только для сжатия: перебрать все и взять самый короткий
+};
+
+const int CODEC_COUNT = 6;
+const char CONTAINER_MAGIC[8] = {'S', 'I', 'A', 'O', 'D', 'C', 'Z', '1'};
+const size_t CONTAINER_HEADER = 12;
+const size_t FRAME_HEADER = 13;
+const size_t DEFAULT_BLOCK_SIZE = 1 << 20;
+// Предел размера блока: распаковщик не выделит больше по чужому заголовку
+const size_t MAX_BLOCK_SIZE = 64 << 20;
+const int LZ77_WINDOW = 1 << 20;
+const int LZ77_CHAIN = 16;
+const int LZW_BITS = 16;
+
+inline const char *codecName(Codec codec) {
+  switch (codec) {
+  case Codec::Stored:
+    return "stored";
+  case Codec::Huffman:
+    return "huffman";
+  case Codec::ShannonFano:
+    return "shannon-fano";
+  case Codec::LZ77:
+    return "lz77";
+  case Codec::LZW:
+    return "lzw";
+  case Codec::TANS:
+    return "tans";
+  case Codec::Auto:
+    return "auto";
+  }
+  return "?";
+}
+
+// Кодек по имени из командной строки; false, если имя неизвестно
+inline bool parseCodec(const std::string &name, Codec &codec) {
+  for (Codec candidate : {Codec::Stored, Codec::Huffman, Codec::ShannonFano,
+                          Codec::LZ77, Codec::LZW, Codec::TANS,
+                          Codec::Auto}) {
+    if (name == codecName(candidate)) {
+      codec = candidate;
+      return true;
+    }
+  }
+  return false;
+}
+
+// CRC32 (многочлен 0xEDB88320) с восемью таблицами: за шаг обрабатывается
+// 8 байтов, и проверка не становится узким местом распаковки
+struct Crc32Table {
+  uint32_t table[8][256];
+
+  Crc32Table() {
+    for (uint32_t i = 0; i < 256; ++i) {
+      uint32_t crc = i;
+      for (int k = 0; k < 8; ++k)
+        crc = crc & 1 ? (crc >> 1) ^ 0xEDB88320u : crc >> 1;
+      table[0][i] = crc;
+    }
+    for (uint32_t i = 0; i < 256; ++i) {
+      for (int t = 1; t < 8; ++t) {
+        uint32_t previous = table[t - 1][i];
+        table[t][i] = (previous >> 8) ^ table[0][previous & 255];
+      }
+    }
+  }
+};
+
+inline uint32_t crc32(const uint8_t *data, size_t size, uint32_t crc = 0) {
+  static const Crc32Table tables;
+  const uint32_t(*table)[256] = tables.table;
+  crc = ~crc;
+  for (; size >= 8; data += 8, size -= 8) {
+    uint32_t low = crc ^ (data[0] | data[1] << 8 | data[2] << 16 |
+                          static_cast<uint32_t>(data[3]) << 24);
+    crc = table[7][low & 255] ^ table[6][(low >> 8) & 255] ^
+          table[5][(low >> 16) & 255] ^ table[4][low >> 24] ^
+          table[3][data[4]] ^ table[2][data[5]] ^ table[1][data[6]] ^
+          table[0][data[7]];
+  }
+  for (; size > 0; --size)
+    crc = (crc >> 8) ^ table[0][(crc ^ *data++) & 255];
+  return ~crc;
+}
+
+inline void storeLittleEndian32(uint8_t *dst, uint32_t value) {
+  for (int i = 0; i < 4; ++i)
+    dst[i] = static_cast<uint8_t>(value >> (8 * i));
+}
+
+inline uint32_t loadLittleEndian32(const uint8_t *src) {
+  return src[0] | src[1] << 8 | src[2] << 16 |
+         static_cast<uint32_t>(src[3]) << 24;
+}
+
+// Сжатие блока одним кодеком (не Auto и не Stored)
+inline std::vector<uint8_t> encodeWith(Codec codec, const uint8_t *data,
+                                       size_t size) {
+  switch (codec) {
+  case Codec::Huffman:
+    return huffmanCompress(data, size);
+  case Codec::ShannonFano:
+    return shannonFanoCompress(data, size);
+  case Codec::LZ77: {
+    std::string input(reinterpret_cast<const char *>(data), size);
+    return packLZ77(encodeLZ77(input, LZ77_WINDOW, LZ77_CHAIN, true), true);
+  }
+  case Codec::LZW:
+    return lzwCompress(data, size, LZW_BITS);
+  case Codec::TANS:
+    return tansCompress(data, size);
+  default:
+    return std::vector<uint8_t>(data, data + size);
+  }
+}
+
+// Сжатие блока. Если кодек не выиграл ни байта, блок хранится как есть:
+// поэтому сжатый размер никогда не больше исходного
+inline Codec compressBlock(Codec codec, const uint8_t *data, size_t size,
+                           std::vector<uint8_t> &packed) {
+  packed.clear();
+  Codec chosen = Codec::Stored;
+  if (codec == Codec::Auto) {
+    for (Codec candidate : {Codec::Huffman, Codec::ShannonFano, Codec::LZ77,
+                            Codec::LZW, Codec::TANS}) {
+      std::vector<uint8_t> attempt = encodeWith(candidate, data, size);
+      if (attempt.size() < size &&
+          (chosen == Codec::Stored || attempt.size() < packed.size())) {
+        packed.swap(attempt);
+        chosen = candidate;
+      }
+    }
+  } else if (codec != Codec::Stored) {
+    packed = encodeWith(codec, data, size);
+    if (packed.size() < size)
+      chosen = codec;
+  }
+  if (chosen == Codec::Stored)
+    packed.assign(data, data + size);
+  return chosen;
+}
+
+// Исходный размер, записанный в заголовке кодека; false, если заголовок
+// обрезан. Хаффман, Шеннон — Фано и tANS начинают поток с 8 байтов
+// размера, LZW — после байтов ширины кода и политики, LZ77 — varint после
+// байта режима
+inline bool declaredSize(Codec codec, const uint8_t *packed,
+                         size_t packedSize, uint64_t &size) {
+  switch (codec) {
+  case Codec::Huffman:
+  case Codec::ShannonFano:
+  case Codec::TANS:
+    if (packedSize < 8)
+      return false;
+    size = loadLittleEndian64(packed);
+    return true;
+  case Codec::LZW:
+    if (packedSize < LZW_HEADER)
+      return false;
+    size = loadLittleEndian64(packed + 2);
+    return true;
+  case Codec::LZ77: {
+    const uint8_t *src = packed + 1;
+    return packedSize > 0 && readVarint(src, packed + packedSize, size);
+  }
+  case Codec::Stored:
+    size = packedSize;
+    return true;
+  default:
+    return false;
+  }
+}
+
+// Распаковка блока; false, если данные повреждены или размер не сошёлся.
+// Размер из заголовка кодека сверяется с кадром до распаковки: декодер
+// выделяет память по своему заголовку, и без проверки каждый поток пула
+// мог бы занять в десятки раз больше размера блока
+inline bool decompressBlock(Codec codec, const uint8_t *packed,
+                            size_t packedSize, size_t size,
+                            std::vector<uint8_t> &output) {
+  uint64_t declared = 0;
+  if (!declaredSize(codec, packed, packedSize, declared) || declared != size)
+    return false;
+  bool ok = false;
+  switch (codec) {
+  case Codec::Stored:
+    output.assign(packed, packed + packedSize);
+    ok = true;
+    break;
+  case Codec::Huffman:
+  case Codec::ShannonFano:
+    ok = huffmanDecompress(packed, packedSize, output);
+    break;
+  case Codec::LZ77: {
+    std::string text;
+    ok = unpackLZ77(packed, packedSize, text);
+    output.assign(text.begin(), text.end());
+    break;
+  }
+  case Codec::LZW:
+    ok = lzwDecompress(packed, packedSize, output);
+    break;
+  case Codec::TANS:
+    ok = tansDecompress(packed, packedSize, output);
+    break;
+  default:
+    break;
+  }
+  return ok && output.size() == size;
+}
+
+// Сводка по потоку: объёмы и число блоков каждого кодека
+struct StreamStats {
+  uint64_t rawBytes = 0;
+  uint64_t packedBytes = 0;
+  uint64_t blocks[CODEC_COUNT] = {0};
+};
+
+// Чтение до size байтов; меньше только в конце потока или при ошибке
+inline size_t readFully(FILE *in, uint8_t *dst, size_t size) {
+  size_t total = 0;
+  while (total < size) {
+    size_t got = std::fread(dst + total, 1, size - total, in);
+    if (got == 0)
+      break;
+    total += got;
+  }
+  return total;
+}
+
+inline bool writeFrame(FILE *out, Codec codec, uint32_t size, uint32_t crc,
+                       const std::vector<uint8_t> &packed) {
+  uint8_t header[FRAME_HEADER];
+  header[0] = static_cast<uint8_t>(codec);
+  storeLittleEndian32(header + 1, size);
+  storeLittleEndian32(header + 5, static_cast<uint32_t>(packed.size()));
+  storeLittleEndian32(header + 9, crc);
+  return std::fwrite(header, 1, FRAME_HEADER, out) == FRAME_HEADER &&
+         std::fwrite(packed.data(), 1, packed.size(), out) == packed.size();
+}
+
+// Блок в работе. Буферы переиспользуются от блока к блоку, поэтому в
+// установившемся режиме конвейер не выделяет память
+struct BlockJob {
+  std::vector<uint8_t> input;
+  std::vector<uint8_t> output;
+  Codec codec = Codec::Stored;
+  uint32_t size = 0; // Исходный размер блока
+  uint32_t crc = 0;
+  uint64_t offset = 0; // Смещение кадра при распаковке по индексу
+  bool ok = false;
+};
+
+// Конвейер блоков. produce заполняет очередной блок (false — вход
+// кончился), process выполняется в рабочих потоках, consume получает
+// готовые блоки строго по порядку; produce и consume вызываются в
+// вызывающем потоке. В работе не больше 2·threads блоков: это буфер
+// переупорядочивания, и он же ограничивает память при любой длине потока
+template <typename Produce, typename Process, typename Consume>
+bool runBlockPipeline(int threads, Produce produce, Process process,
+                      Consume consume) {
+  if (threads <= 1) {
+    BlockJob job;
+    while (produce(job)) {
+      process(job);
+      if (!consume(job))
+        return false;
+    }
+    return true;
+  }
+
+  const size_t window = 2 * static_cast<size_t>(threads);
+  std::vector<BlockJob> jobs(window);
+  std::vector<char> done(window, 0);
+  std::deque<size_t> queue;
+  std::mutex mutex;
+  std::condition_variable workReady, jobDone;
+  bool stop = false;
+
+  std::vector<std::thread> workers;
+  for (int w = 0; w < threads; ++w) {
+    workers.emplace_back([&] {
+      std::unique_lock<std::mutex> lock(mutex);
+      while (true) {
+        workReady.wait(lock, [&] { return stop || !queue.empty(); });
+        if (queue.empty())
+          return;
+        size_t slot = queue.front();
+        queue.pop_front();
+        lock.unlock();
+        process(jobs[slot]);
+        lock.lock();
+        done[slot] = 1;
+        jobDone.notify_one();
+      }
+    });
+  }
+
+  uint64_t produced = 0, consumed = 0;
+  bool more = true, ok = true;
+  while (true) {
+    // После ошибки новые блоки не берутся, уже выданные дорабатываются
+    while (more && ok && produced - consumed < window) {
+      size_t slot = produced % window;
+      if (!produce(jobs[slot])) {
+        more = false;
+        break;
+      }
+      {
+        std::lock_guard<std::mutex> lock(mutex);
+        done[slot] = 0;
+        queue.push_back(slot);
+      }
+      workReady.notify_one();
+      ++produced;
+    }
+    if (consumed == produced)
+      break;
+    size_t slot = consumed % window;
+    {
+      std::unique_lock<std::mutex> lock(mutex);
+      jobDone.wait(lock, [&] { return done[slot] != 0; });
+    }
+    if (ok && !consume(jobs[slot]))
+      ok = false;
+    ++consumed;
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    stop = true;
+  }
+  workReady.notify_all();
+  for (std::thread &worker : workers)
+    worker.join();
+  return ok;
+}
+
+inline unsigned defaultThreads() {
+  return std::max(1u, std::thread::hardware_concurrency());
+}
+
+// Индекс блоков — данные завершающего кадра: пары (исходный размер, сжатый
+// размер) по 4 байта и число блоков последними четырьмя байтами файла
+const size_t INDEX_ENTRY = 8;
+
+inline void appendIndexEntry(std::vector<uint8_t> &index, uint32_t size,
+                             uint32_t packedSize) {
+  uint8_t entry[INDEX_ENTRY];
+  storeLittleEndian32(entry, size);
+  storeLittleEndian32(entry + 4, packedSize);
+  index.insert(index.end(), entry, entry + INDEX_ENTRY);
+}
+
+inline bool compressStream(FILE *in, FILE *out, Codec codec,
+                           size_t blockSize = DEFAULT_BLOCK_SIZE,
+                           int threads = 1, StreamStats *stats = nullptr) {
+  if (blockSize == 0 || blockSize > MAX_BLOCK_SIZE)
+    return false;
+  uint8_t header[CONTAINER_HEADER];
+  std::memcpy(header, CONTAINER_MAGIC, sizeof(CONTAINER_MAGIC));
+  storeLittleEndian32(header + 8, static_cast<uint32_t>(blockSize));
+  if (std::fwrite(header, 1, CONTAINER_HEADER, out) != CONTAINER_HEADER)
+    return false;
+
+  std::vector<uint8_t> index;
+  uint32_t blocks = 0;
+  bool finished = false;
+  bool ok = runBlockPipeline(
+      threads,
+      [&](BlockJob &job) {
+        if (finished)
+          return false;
+        job.input.resize(blockSize);
+        size_t size = readFully(in, job.input.data(), blockSize);
+        finished = size < blockSize;
+        job.input.resize(size);
+        return size > 0;
+      },
+      [&](BlockJob &job) {
+        job.codec = compressBlock(codec, job.input.data(), job.input.size(),
+                                  job.output);
+        job.crc = crc32(job.input.data(), job.input.size());
+      },
+      [&](BlockJob &job) {
+        uint32_t size = static_cast<uint32_t>(job.input.size());
+        // Индекс должен уместиться в 32-битный размер завершающего кадра
+        if (blocks >= (UINT32_MAX - 4) / INDEX_ENTRY ||
+            !writeFrame(out, job.codec, size, job.crc, job.output))
+          return false;
+        appendIndexEntry(index, size, static_cast<uint32_t>(job.output.size()));
+        blocks++;
+        if (stats) {
+          stats->rawBytes += size;
+          stats->packedBytes += FRAME_HEADER + job.output.size();
+          stats->blocks[static_cast<int>(job.codec)]++;
+        }
+        return true;
+      });
+  if (!ok || std::ferror(in))
+    return false;
+
+  uint8_t count[4];
+  storeLittleEndian32(count, blocks);
+  index.insert(index.end(), count, count + 4);
+  return writeFrame(out, Codec::Stored, 0, crc32(index.data(), index.size()),
+                    index) &&
+         std::fflush(out) == 0;
+}
+
+struct BlockIndexEntry {
+  uint64_t offset; // Смещение кадра от начала файла
+  uint32_t size;
+  uint32_t packedSize;
+};
+
+// Разбор завершающего кадра. Сверяется с блоками, которые уже прочитаны
+inline bool parseBlockIndex(const uint8_t *frame, size_t frameSize,
+                            uint64_t firstFrame, uint32_t blockSize,
+                            std::vector<BlockIndexEntry> &index) {
+  if (frameSize < FRAME_HEADER + 4 || frame[0] != 0 ||
+      loadLittleEndian32(frame + 1) != 0 ||
+      loadLittleEndian32(frame + 5) != frameSize - FRAME_HEADER)
+    return false;
+  const uint8_t *payload = frame + FRAME_HEADER;
+  size_t payloadSize = frameSize - FRAME_HEADER;
+  uint32_t blocks = loadLittleEndian32(payload + payloadSize - 4);
+  if (crc32(payload, payloadSize) != loadLittleEndian32(frame + 9) ||
+      payloadSize != static_cast<uint64_t>(blocks) * INDEX_ENTRY + 4)
+    return false;
+
+  index.resize(blocks);
+  uint64_t offset = firstFrame;
+  for (uint32_t b = 0; b < blocks; ++b) {
+    BlockIndexEntry &entry = index[b];
+    entry.offset = offset;
+    entry.size = loadLittleEndian32(payload + b * INDEX_ENTRY);
+    entry.packedSize = loadLittleEndian32(payload + b * INDEX_ENTRY + 4);
+    if (entry.size == 0 || entry.size > blockSize ||
+        entry.packedSize > entry.size)
+      return false;
+    offset += FRAME_HEADER + entry.packedSize;
+  }
+  return true;
+}
+
+// Индекс с конца файла. false, если вход нельзя перемотать (канал) или
+// индекс не сходится с файлом: тогда кадры читаются по порядку
+inline bool readBlockIndex(FILE *in, uint32_t blockSize,
+                           std::vector<BlockIndexEntry> &index) {
+  // Кадры читаются через pread, поэтому нужен настоящий дескриптор
+  long start = std::ftell(in);
+  if (fileno(in) < 0 || start < 0 || std::fseek(in, 0, SEEK_END) != 0)
+    return false;
+  long fileSize = std::ftell(in);
+  bool ok = false;
+  uint8_t count[4];
+  if (fileSize >= start + static_cast<long>(FRAME_HEADER + 4) &&
+      std::fseek(in, fileSize - 4, SEEK_SET) == 0 &&
+      readFully(in, count, 4) == 4) {
+    uint64_t frameSize = FRAME_HEADER + 4 +
+                         static_cast<uint64_t>(loadLittleEndian32(count)) *
+                             INDEX_ENTRY;
+    if (frameSize <= static_cast<uint64_t>(fileSize - start) &&
+        std::fseek(in, fileSize - static_cast<long>(frameSize), SEEK_SET) ==
+            0) {
+      std::vector<uint8_t> frame(frameSize);
+      ok = readFully(in, frame.data(), frameSize) == frameSize &&
+           parseBlockIndex(frame.data(), frameSize, start, blockSize, index) &&
+           (index.empty() ? static_cast<uint64_t>(start)
+                          : index.back().offset + FRAME_HEADER +
+                                index.back().packedSize) ==
+               static_cast<uint64_t>(fileSize) - frameSize;
+    }
+  }
+  std::clearerr(in);
+  return std::fseek(in, start, SEEK_SET) == 0 && ok;
+}
+
+// Чтение кадра по смещению без общей позиции файла: рабочие потоки читают
+// свои блоки независимо
+inline bool readAt(FILE *in, uint64_t offset, uint8_t *dst, size_t size) {
+  int fd = fileno(in);
+  while (size > 0) {
+    ssize_t got = pread(fd, dst, size, static_cast<off_t>(offset));
+    if (got <= 0)
+      return false;
+    dst += got;
+    offset += got;
+    size -= got;
+  }
+  return true;
+}
+
+// Распаковка блока задания и проверка CRC
+inline void decodeJob(BlockJob &job) {
+  job.ok = decompressBlock(job.codec, job.input.data(), job.input.size(),
+                           job.size, job.output) &&
+           crc32(job.output.data(), job.size) == job.crc;
+}
+
+// Заголовок кадра блока. Проверяется до выделения памяти: размер не больше
+// блока из заголовка файла, сжатые данные не длиннее исходных
+inline bool parseFrame(const uint8_t *frame, uint32_t blockSize,
+                       BlockJob &job, uint32_t &packedSize) {
+  job.codec = static_cast<Codec>(frame[0]);
+  job.size = loadLittleEndian32(frame + 1);
+  packedSize = loadLittleEndian32(frame + 5);
+  job.crc = loadLittleEndian32(frame + 9);
+  return frame[0] < CODEC_COUNT && job.size > 0 && job.size <= blockSize &&
+         packedSize <= job.size;
+}
+
+// Распаковка потока. Если вход — файл с индексом, рабочие потоки сами
+// читают свои кадры по смещениям; из канала кадры читаются по порядку,
+// а распаковываются всё равно параллельно
+inline bool decompressStream(FILE *in, FILE *out, int threads = 1,
+                             StreamStats *stats = nullptr) {
+  uint8_t header[CONTAINER_HEADER];
+  if (readFully(in, header, CONTAINER_HEADER) != CONTAINER_HEADER ||
+      std::memcmp(header, CONTAINER_MAGIC, sizeof(CONTAINER_MAGIC)) != 0)
+    return false;
+  uint32_t blockSize = loadLittleEndian32(header + 8);
+  if (blockSize == 0 || blockSize > MAX_BLOCK_SIZE)
+    return false;
+
+  auto consume = [&](BlockJob &job) {
+    if (!job.ok || std::fwrite(job.output.data(), 1, job.size, out) != job.size)
+      return false;
+    if (stats) {
+      stats->rawBytes += job.size;
+      stats->packedBytes += FRAME_HEADER + job.input.size();
+      stats->blocks[static_cast<int>(job.codec)]++;
+    }
+    return true;
+  };
+
+  std::vector<BlockIndexEntry> index;
+  if (threads > 1 && readBlockIndex(in, blockSize, index)) {
+    size_t next = 0;
+    bool ok = runBlockPipeline(
+        threads,
+        [&](BlockJob &job) {
+          if (next == index.size())
+            return false;
+          job.offset = index[next].offset;
+          job.input.resize(FRAME_HEADER + index[next].packedSize);
+          next++;
+          return true;
+        },
+        [&](BlockJob &job) {
+          uint32_t packedSize;
+          job.ok = readAt(in, job.offset, job.input.data(),
+                          job.input.size()) &&
+                   parseFrame(job.input.data(), blockSize, job, packedSize) &&
+                   packedSize == job.input.size() - FRAME_HEADER;
+          if (!job.ok)
+            return;
+          job.input.erase(job.input.begin(),
+                          job.input.begin() + FRAME_HEADER);
+          decodeJob(job);
+        },
+        consume);
+    return ok && std::fflush(out) == 0;
+  }
+
+  // Размеры прочитанных блоков, чтобы сверить с индексом в конце потока
+  std::vector<uint8_t> seen;
+  bool finished = false;
+  bool ok = runBlockPipeline(
+      threads,
+      [&](BlockJob &job) {
+        uint8_t frame[FRAME_HEADER];
+        uint32_t packedSize;
+        if (readFully(in, frame, FRAME_HEADER) != FRAME_HEADER)
+          return false;
+        if (loadLittleEndian32(frame + 1) == 0) {
+          // Завершающий кадр: индекс блоков, а в файлах без индекса пусто
+          packedSize = loadLittleEndian32(frame + 5);
+          bool valid = frame[0] == 0;
+          if (valid && packedSize != 0) {
+            std::vector<uint8_t> end(frame, frame + FRAME_HEADER);
+            end.resize(FRAME_HEADER + seen.size() + 4);
+            std::vector<BlockIndexEntry> entries;
+            valid = packedSize == seen.size() + 4 &&
+                    readFully(in, end.data() + FRAME_HEADER, packedSize) ==
+                        packedSize &&
+                    parseBlockIndex(end.data(), end.size(), 0, blockSize,
+                                    entries) &&
+                    (seen.empty() ||
+                     std::memcmp(end.data() + FRAME_HEADER, seen.data(),
+                                 seen.size()) == 0);
+          } else if (valid) {
+            valid = loadLittleEndian32(frame + 9) == 0;
+          }
+          // За концом потока ничего быть не должно
+          finished = valid && std::fgetc(in) == EOF;
+          return false;
+        }
+        if (!parseFrame(frame, blockSize, job, packedSize))
+          return false;
+        job.input.resize(packedSize);
+        if (readFully(in, job.input.data(), packedSize) != packedSize)
+          return false;
+        appendIndexEntry(seen, job.size, packedSize);
+        return true;
+      },
+      decodeJob, consume);
+  return ok && finished && std::fflush(out) == 0;
+}
+
+#endif // SIAOD_COMPRESS_H
@@ -0,0 +1,439 @@
+// Канонический код Хаффмана над байтами: гистограмма, дерево в массиве,
+// упаковка в байты и табличное декодирование. Общий для кодеков 8_1
+#ifndef SIAOD_HUFFMAN_H
+#define SIAOD_HUFFMAN_H
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+// Предел входа кодеров на частотах: счётчики частот 32-битные
+const uint64_t MAX_ENTROPY_INPUT = UINT32_MAX;
+
+// Подсчёт частот байтов в плоском массиве на 256 счётчиков. Четыре
+// частичные гистограммы убирают зависимость между соседними одинаковыми
+// байтами. Вход не длиннее MAX_ENTROPY_INPUT
+inline void countFrequencies(const uint8_t *data, size_t size,
+                             uint32_t freq[256]) {
+  uint32_t partial[4][256] = {{0}};
+  size_t i = 0;
+  for (; i + 4 <= size; i += 4) {
+    partial[0][data[i]]++;
+    partial[1][data[i + 1]]++;
+    partial[2][data[i + 2]]++;
+    partial[3][data[i + 3]]++;
+  }
+  for (; i < size; ++i)
+    partial[0][data[i]]++;
+  for (int s = 0; s < 256; ++s)
+    freq[s] = partial[0][s] + partial[1][s] + partial[2][s] + partial[3][s];
+}
+
+struct Node {
+  uint64_t frequency;
+  int16_t left;  // -1 у листа
+  int16_t right;
+  uint8_t character;
+};
+
+// Дерево Хаффмана в фиксированном массиве без выделений памяти на узел.
+// Листья лежат первыми по возрастанию частоты, внутренние узлы — за ними
+// в порядке создания, корень последний
+struct HuffmanTree {
+  Node nodes[511];
+  int leaves = 0;
+  int size = 0;
+
+  int root() const { return size - 1; }
+};
+
+// Построение дерева Хаффмана за O(n) после сортировки листьев: две очереди,
+// листья и внутренние узлы, обе упорядочены по частоте, минимум берётся
+// из их голов
+inline void buildHuffmanTree(const uint32_t freq[256], HuffmanTree &tree) {
+  tree.leaves = 0;
+  for (int s = 0; s < 256; ++s) {
+    if (freq[s])
+      tree.nodes[tree.leaves++] = {freq[s], -1, -1, static_cast<uint8_t>(s)};
+  }
+  std::sort(tree.nodes, tree.nodes + tree.leaves,
+            [](const Node &a, const Node &b) {
+              return a.frequency != b.frequency ? a.frequency < b.frequency
+                                                : a.character < b.character;
+            });
+  tree.size = tree.leaves;
+
+  int leaf = 0, inner = tree.leaves;
+  auto takeMin = [&]() {
+    if (leaf < tree.leaves &&
+        (inner == tree.size ||
+         tree.nodes[leaf].frequency <= tree.nodes[inner].frequency))
+      return leaf++;
+    return inner++;
+  };
+  while (tree.size < 2 * tree.leaves - 1) {
+    int left = takeMin();
+    int right = takeMin();
+    tree.nodes[tree.size] = {tree.nodes[left].frequency +
+                                 tree.nodes[right].frequency,
+                             static_cast<int16_t>(left),
+                             static_cast<int16_t>(right), 0};
+    tree.size++;
+  }
+}
+
+// Канонический код Хаффмана: длины кодов не больше MAX_CODE_LENGTH, вывод
+// упакован в байты, декодирование идёт по таблице на LOOKUP_BITS бит сразу
+const int MAX_CODE_LENGTH = 15;
+const int LOOKUP_BITS = 11;
+const int LOOKUP_SIZE = 1 << LOOKUP_BITS;
+// Заголовок: исходный размер (8 байт) и длины кодов по 4 бита на байт
+const size_t HUFFMAN_HEADER = 8 + 128;
+
+// Длины и коды всех 256 байтов. Поток пишется младшими битами вперёд,
+// поэтому биты каждого кода хранятся в обратном порядке
+struct CanonicalCode {
+  uint8_t lengths[256];
+  uint16_t codes[256];
+};
+
+// Ограничение длин кодов MAX_CODE_LENGTH битами. order — символы с ненулевой
+// длиной по возрастанию частоты. Пока неравенство Крафта нарушено, самый
+// длинный лист переезжает под лист покороче, который уходит на уровень ниже;
+// затем короткие коды раздаются самым частым символам
+inline void limitCodeLengths(uint8_t lengths[256], const uint8_t *order,
+                             int symbols) {
+  int maxLength = 0;
+  int count[MAX_CODE_LENGTH + 1] = {0};
+  for (int i = 0; i < symbols; ++i) {
+    maxLength = std::max<int>(maxLength, lengths[order[i]]);
+    count[std::min<int>(lengths[order[i]], MAX_CODE_LENGTH)]++;
+  }
+  if (maxLength <= MAX_CODE_LENGTH)
+    return;
+
+  uint32_t total = 0;
+  for (int len = 1; len <= MAX_CODE_LENGTH; ++len)
+    total += count[len] << (MAX_CODE_LENGTH - len);
+  while (total > (1u << MAX_CODE_LENGTH)) {
+    count[MAX_CODE_LENGTH]--;
+    for (int len = MAX_CODE_LENGTH - 1; len > 0; --len) {
+      if (count[len]) {
+        count[len]--;
+        count[len + 1] += 2;
+        break;
+      }
+    }
+    total--;
+  }
+
+  int next = symbols - 1;
+  for (int len = 1; len <= MAX_CODE_LENGTH; ++len) {
+    for (int k = 0; k < count[len]; ++k)
+      lengths[order[next--]] = static_cast<uint8_t>(len);
+  }
+}
+
+// Длины кодов по частотам. Потомки в дереве всегда лежат раньше родителя,
+// поэтому глубины считаются одним проходом от корня
+inline void buildCodeLengths(const uint32_t freq[256], uint8_t lengths[256]) {
+  std::fill(lengths, lengths + 256, 0);
+  HuffmanTree tree;
+  buildHuffmanTree(freq, tree);
+  if (tree.size == 0)
+    return;
+  if (tree.size == 1) {
+    lengths[tree.nodes[0].character] = 1;
+    return;
+  }
+
+  int depth[511];
+  depth[tree.root()] = 0;
+  for (int i = tree.root(); i >= tree.leaves; --i)
+    depth[tree.nodes[i].left] = depth[tree.nodes[i].right] = depth[i] + 1;
+
+  // Листья уже отсортированы по возрастанию частоты
+  uint8_t order[256];
+  for (int i = 0; i < tree.leaves; ++i) {
+    order[i] = tree.nodes[i].character;
+    lengths[order[i]] = static_cast<uint8_t>(depth[i]);
+  }
+  limitCodeLengths(lengths, order, tree.leaves);
+}
+
+// Чтение 8 байтов, младший байт первым, на любой платформе
+inline uint64_t loadLittleEndian64(const uint8_t *src) {
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+  uint64_t word;
+  std::memcpy(&word, src, sizeof(word));
+  return word;
+#else
+  uint64_t word = 0;
+  for (int i = 0; i < 8; ++i)
+    word |= static_cast<uint64_t>(src[i]) << (8 * i);
+  return word;
+#endif
+}
+
+inline uint16_t reverseBits(uint32_t code, int length) {
+  uint32_t result = 0;
+  for (int i = 0; i < length; ++i) {
+    result = (result << 1) | (code & 1);
+    code >>= 1;
+  }
+  return static_cast<uint16_t>(result);
+}
+
+// Канонические коды: внутри одной длины коды идут подряд по порядку байтов
+inline void assignCanonicalCodes(CanonicalCode &code) {
+  int count[MAX_CODE_LENGTH + 1] = {0};
+  for (int s = 0; s < 256; ++s)
+    count[code.lengths[s]]++;
+  count[0] = 0;
+  uint32_t next[MAX_CODE_LENGTH + 1];
+  uint32_t value = 0;
+  for (int len = 1; len <= MAX_CODE_LENGTH; ++len) {
+    value = (value + count[len - 1]) << 1;
+    next[len] = value;
+  }
+  for (int s = 0; s < 256; ++s) {
+    int len = code.lengths[s];
+    code.codes[s] = len ? reverseBits(next[len]++, len) : 0;
+  }
+}
+
+// Таблица декодирования. Запись по очередным LOOKUP_BITS битам потока хранит
+// до трёх целиком помещающихся в них символов и число занятых ими бит.
+// Коды длиннее LOOKUP_BITS разбираются по длинам (count == 0 в записи)
+class HuffmanDecoder {
+private:
+  struct Entry {
+    uint8_t symbols[3];
+    uint8_t info; // Число символов << 4 | число бит
+  };
+
+  Entry table[LOOKUP_SIZE];
+  uint8_t lengths[256];
+  uint32_t firstCode[MAX_CODE_LENGTH + 1];
+  uint32_t lengthCount[MAX_CODE_LENGTH + 1];
+  uint32_t firstIndex[MAX_CODE_LENGTH + 1];
+  uint8_t sorted[256];
+
+  // Длинный код: старшие биты кода идут в потоке первыми. Возвращает длину
+  // кода или 0, если такого кода нет
+  int decodeLong(uint64_t buffer, uint8_t &symbol) const {
+    uint32_t value = 0;
+    for (int len = 1; len <= MAX_CODE_LENGTH; ++len) {
+      value = value << 1 | ((buffer >> (len - 1)) & 1);
+      if (value - firstCode[len] < lengthCount[len]) {
+        symbol = sorted[firstIndex[len] + value - firstCode[len]];
+        return len;
+      }
+    }
+    return 0;
+  }
+
+public:
+  // false, если длины не образуют префиксный код
+  bool build(const uint8_t codeLengths[256]) {
+    CanonicalCode code;
+    std::memcpy(code.lengths, codeLengths, 256);
+    std::memcpy(lengths, codeLengths, 256);
+    assignCanonicalCodes(code);
+
+    uint32_t kraft = 0;
+    std::fill(lengthCount, lengthCount + MAX_CODE_LENGTH + 1, 0);
+    for (int s = 0; s < 256; ++s) {
+      if (lengths[s] > MAX_CODE_LENGTH)
+        return false;
+      if (lengths[s]) {
+        lengthCount[lengths[s]]++;
+        kraft += 1u << (MAX_CODE_LENGTH - lengths[s]);
+      }
+    }
+    if (kraft > (1u << MAX_CODE_LENGTH))
+      return false;
+
+    // Первый код и первый индекс в sorted для каждой длины
+    uint32_t value = 0, index = 0;
+    for (int len = 1; len <= MAX_CODE_LENGTH; ++len) {
+      value = (value + lengthCount[len - 1]) << 1;
+      firstCode[len] = value;
+      firstIndex[len] = index;
+      index += lengthCount[len];
+    }
+    uint32_t fill[MAX_CODE_LENGTH + 1];
+    std::memcpy(fill, firstIndex, sizeof(fill));
+    for (int s = 0; s < 256; ++s) {
+      if (lengths[s])
+        sorted[fill[lengths[s]]++] = static_cast<uint8_t>(s);
+    }
+
+    // Сначала таблица по одному символу, затем из неё — многосимвольная
+    std::vector<uint16_t> single(LOOKUP_SIZE, 0); // символ << 8 | длина
+    for (int s = 0; s < 256; ++s) {
+      int len = lengths[s];
+      if (len && len <= LOOKUP_BITS) {
+        for (uint32_t i = code.codes[s]; i < LOOKUP_SIZE; i += 1u << len)
+          single[i] = static_cast<uint16_t>(s << 8 | len);
+      }
+    }
+    for (uint32_t i = 0; i < LOOKUP_SIZE; ++i) {
+      Entry &entry = table[i];
+      int count = 0, used = 0;
+      while (count < 3) {
+        uint16_t hit = single[(i >> used) & (LOOKUP_SIZE - 1)];
+        int len = hit & 0xFF;
+        if (!len || used + len > LOOKUP_BITS)
+          break;
+        entry.symbols[count++] = static_cast<uint8_t>(hit >> 8);
+        used += len;
+      }
+      for (int k = count; k < 3; ++k)
+        entry.symbols[k] = 0;
+      entry.info = static_cast<uint8_t>(count << 4 | used);
+    }
+    return true;
+  }
+
+  // Декодирование ровно size байтов из потока [src, end)
+  bool decode(const uint8_t *src, const uint8_t *end, uint8_t *out,
+              size_t size) const {
+    const uint64_t available = static_cast<uint64_t>(end - src) * 8;
+    uint64_t consumed = 0;
+    uint64_t buffer = 0;
+    int bits = 0;
+    size_t pos = 0;
+    while (pos < size) {
+      // Дочитываем буфер минимум до 56 бит; за концом потока идут нули
+      if (end - src >= 8) {
+        buffer |= loadLittleEndian64(src) << bits;
+        src += (63 - bits) >> 3;
+        bits |= 56;
+      } else {
+        while (bits <= 56) {
+          if (src < end)
+            buffer |= static_cast<uint64_t>(*src++) << bits;
+          bits += 8;
+        }
+      }
+
+      // 56 бит хватает на три записи таблицы, даже если все коды длинные
+      for (int step = 0; step < 3 && pos < size; ++step) {
+        const Entry &entry = table[buffer & (LOOKUP_SIZE - 1)];
+        size_t count = entry.info >> 4;
+        int used = entry.info & 15;
+        if (count && size - pos >= 3) {
+          // Лишние байты перезапишутся следующими символами
+          std::memcpy(out + pos, entry.symbols, 3);
+          pos += count;
+        } else if (count) {
+          out[pos++] = entry.symbols[0];
+          used = lengths[entry.symbols[0]];
+        } else {
+          used = decodeLong(buffer, out[pos++]);
+          if (!used)
+            return false;
+        }
+        buffer >>= used;
+        bits -= used;
+        consumed += used;
+      }
+    }
+    return consumed <= available;
+  }
+};
+
+// Сжатие каноническим кодом с заданными длинами: заголовок с размером и
+// длинами кодов, затем упакованные коды. freq — частоты байтов data.
+// Пустой результат — вход длиннее MAX_ENTROPY_INPUT: частоты в счётчиках
+// переполнились бы, и буфер оказался бы меньше потока
+inline std::vector<uint8_t> canonicalCompress(const uint8_t *data, size_t size,
+                                              const uint32_t freq[256],
+                                              const uint8_t lengths[256]) {
+  if (size > MAX_ENTROPY_INPUT)
+    return {};
+  CanonicalCode code;
+  std::memcpy(code.lengths, lengths, 256);
+  assignCanonicalCodes(code);
+
+  uint64_t totalBits = 0;
+  for (int s = 0; s < 256; ++s)
+    totalBits += static_cast<uint64_t>(freq[s]) * code.lengths[s];
+  std::vector<uint8_t> packed(HUFFMAN_HEADER + (totalBits + 7) / 8 + 8);
+  uint64_t originalSize = size;
+  for (int i = 0; i < 8; ++i)
+    packed[i] = static_cast<uint8_t>(originalSize >> (8 * i));
+  for (int s = 0; s < 256; s += 2)
+    packed[8 + s / 2] =
+        static_cast<uint8_t>(code.lengths[s] | code.lengths[s + 1] << 4);
+
+  // 64-битный буфер: символы дописываются сверху, по 32 бита уходят в вывод
+  uint8_t *dst = packed.data() + HUFFMAN_HEADER;
+  uint64_t buffer = 0;
+  int bits = 0;
+  for (size_t i = 0; i < size; ++i) {
+    buffer |= static_cast<uint64_t>(code.codes[data[i]]) << bits;
+    bits += code.lengths[data[i]];
+    if (bits >= 32) {
+      dst[0] = static_cast<uint8_t>(buffer);
+      dst[1] = static_cast<uint8_t>(buffer >> 8);
+      dst[2] = static_cast<uint8_t>(buffer >> 16);
+      dst[3] = static_cast<uint8_t>(buffer >> 24);
+      dst += 4;
+      buffer >>= 32;
+      bits -= 32;
+    }
+  }
+  while (bits > 0) {
+    *dst++ = static_cast<uint8_t>(buffer);
+    buffer >>= 8;
+    bits -= 8;
+  }
+  packed.resize(dst - packed.data());
+  return packed;
+}
+
+inline std::vector<uint8_t> huffmanCompress(const uint8_t *data, size_t size) {
+  if (size > MAX_ENTROPY_INPUT)
+    return {};
+  uint32_t freq[256];
+  countFrequencies(data, size, freq);
+  uint8_t lengths[256];
+  buildCodeLengths(freq, lengths);
+  return canonicalCompress(data, size, freq, lengths);
+}
+
+// Распаковка любого канонического потока, не только кода Хаффмана
+inline bool huffmanDecompress(const uint8_t *packed, size_t size,
+                              std::vector<uint8_t> &output) {
+  if (size < HUFFMAN_HEADER)
+    return false;
+  uint64_t originalSize = 0;
+  for (int i = 0; i < 8; ++i)
+    originalSize |= static_cast<uint64_t>(packed[i]) << (8 * i);
+  uint8_t lengths[256];
+  for (int s = 0; s < 256; s += 2) {
+    lengths[s] = packed[8 + s / 2] & 15;
+    lengths[s + 1] = packed[8 + s / 2] >> 4;
+  }
+
+  const uint8_t *src = packed + HUFFMAN_HEADER;
+  const uint8_t *end = packed + size;
+  // Каждый символ занимает хотя бы бит: защита от огромного размера в заголовке
+  if (originalSize > static_cast<uint64_t>(end - src) * 8)
+    return false;
+  HuffmanDecoder decoder;
+  if (!decoder.build(lengths))
+    return false;
+  output.resize(originalSize);
+  return decoder.decode(src, end, output.data(), originalSize);
+}
+
+inline bool huffmanDecompress(const std::vector<uint8_t> &packed,
+                              std::vector<uint8_t> &output) {
+  return huffmanDecompress(packed.data(), packed.size(), output);
+}
+
+#endif // SIAOD_HUFFMAN_H
@@ -0,0 +1,424 @@
+// LZ77: поиск совпадений по хеш-цепочкам, двоичный формат с varint и
+// быстрая распаковка
+#ifndef SIAOD_LZ77_H
+#define SIAOD_LZ77_H
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "huffman.h"
+
+struct LZ77Token {
+  int offset;
+  int length;
+  char nextChar;
+};
+
+// Запас в конце буфера вывода: копирование идёт блоками по 16 байтов
+const size_t COPY_SLACK = 16;
+
+// Копирование совпадения из уже восстановленной части вывода. Может
+// записать до 15 байтов за концом совпадения, их перезапишут следующие
+inline void copyMatch(uint8_t *dst, size_t offset, size_t length) {
+  const uint8_t *src = dst - offset;
+  uint8_t *end = dst + length;
+  if (offset >= 16) {
+    // Каждый блок читает только байты, записанные раньше
+    do {
+      std::memcpy(dst, src, 16);
+      dst += 16;
+      src += 16;
+    } while (dst < end);
+    return;
+  }
+  uint8_t pattern[16];
+  if (length <= offset) {
+    // Короткое совпадение целиком лежит до dst: один блок через регистр
+    std::memcpy(pattern, src, 16);
+    std::memcpy(dst, pattern, 16);
+    return;
+  }
+  // Перекрытие: период из offset байтов размножается в 16-байтовый шаблон,
+  // который пишется с шагом, кратным периоду
+  for (size_t i = 0, j = 0; i < 16; ++i) {
+    pattern[i] = src[j];
+    if (++j == offset)
+      j = 0;
+  }
+  size_t step = 16 - 16 % offset;
+  while (dst < end) {
+    std::memcpy(dst, pattern, 16);
+    dst += step;
+  }
+}
+
+// Функция декодирования для LZ77
+inline std::string decodeLZ77(const std::vector<LZ77Token> &tokens) {
+  size_t size = 0;
+  for (const auto &token : tokens)
+    size += token.length + 1;
+  std::string decoded(size + COPY_SLACK, '\0');
+  uint8_t *out = reinterpret_cast<uint8_t *>(&decoded[0]);
+
+  size_t pos = 0;
+  for (const auto &token : tokens) {
+    if (token.length > 0) {
+      copyMatch(out + pos, token.offset, token.length);
+      pos += token.length;
+    }
+    out[pos++] = static_cast<uint8_t>(token.nextChar);
+  }
+
+  decoded.resize(size);
+  return decoded;
+}
+
+// Двоичный формат LZ77: флаги, исходный размер и число токенов, затем поток
+// команд (длина и, если она не ноль, смещение) и поток символов nextChar.
+// Числа записаны varint по 7 бит. С флагом LZ77_HUFFMAN оба потока сжаты
+// каноническим кодом Хаффмана
+const uint8_t LZ77_HUFFMAN = 1;
+
+inline void writeVarint(std::vector<uint8_t> &out, uint64_t value) {
+  while (value >= 0x80) {
+    out.push_back(static_cast<uint8_t>(value | 0x80));
+    value >>= 7;
+  }
+  out.push_back(static_cast<uint8_t>(value));
+}
+
+inline bool readVarint(const uint8_t *&src, const uint8_t *end,
+                       uint64_t &value) {
+  if (src < end && *src < 0x80) {
+    value = *src++;
+    return true;
+  }
+  value = 0;
+  for (int shift = 0; shift < 64; shift += 7) {
+    if (src == end)
+      return false;
+    uint8_t byte = *src++;
+    value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+    if (byte < 0x80)
+      return true;
+  }
+  return false;
+}
+
+// Чтение varint без ветвления для одного и двух байтов, которые почти всегда
+// и встречаются в командах; более длинные числа — общим путём
+inline bool readShortVarint(const uint8_t *&src, const uint8_t *end,
+                            uint64_t &value) {
+  if (end - src < 2)
+    return readVarint(src, end, value);
+  uint32_t first = src[0], second = src[1];
+  uint32_t more = first >> 7;
+  if (more & (second >> 7))
+    return readVarint(src, end, value);
+  value = (first & 0x7F) | ((second << 7) & (0u - more));
+  src += 1 + more;
+  return true;
+}
+
+// Запись потока с длиной впереди, при entropy — через код Хаффмана
+inline void appendStream(std::vector<uint8_t> &out,
+                         const std::vector<uint8_t> &stream, bool entropy) {
+  if (entropy) {
+    std::vector<uint8_t> packed = huffmanCompress(stream.data(), stream.size());
+    writeVarint(out, packed.size());
+    out.insert(out.end(), packed.begin(), packed.end());
+  } else {
+    writeVarint(out, stream.size());
+    out.insert(out.end(), stream.begin(), stream.end());
+  }
+}
+
+inline std::vector<uint8_t> packLZ77(const std::vector<LZ77Token> &tokens,
+                                     bool entropy = false) {
+  std::vector<uint8_t> commands, literals;
+  commands.reserve(tokens.size() * 2);
+  literals.reserve(tokens.size());
+  uint64_t size = 0;
+  for (const auto &token : tokens) {
+    writeVarint(commands, token.length);
+    if (token.length > 0)
+      writeVarint(commands, token.offset);
+    literals.push_back(static_cast<uint8_t>(token.nextChar));
+    size += token.length + 1;
+  }
+
+  std::vector<uint8_t> packed;
+  packed.push_back(entropy ? LZ77_HUFFMAN : 0);
+  writeVarint(packed, size);
+  writeVarint(packed, tokens.size());
+  appendStream(packed, commands, entropy);
+  appendStream(packed, literals, entropy);
+  return packed;
+}
+
+// Чтение потока; сжатый поток распаковывается в storage
+inline bool readStream(const uint8_t *&src, const uint8_t *end,
+                       bool entropy, std::vector<uint8_t> &storage,
+                       const uint8_t *&begin, const uint8_t *&finish) {
+  uint64_t length;
+  if (!readVarint(src, end, length) ||
+      length > static_cast<uint64_t>(end - src))
+    return false;
+  if (entropy) {
+    if (!huffmanDecompress(src, length, storage))
+      return false;
+    begin = storage.data();
+    finish = storage.data() + storage.size();
+  } else {
+    begin = src;
+    finish = src + length;
+  }
+  src += length;
+  return true;
+}
+
+// Распаковка: вывод выделяется сразу целиком по размеру из заголовка,
+// каждая команда проверяется, прежде чем копировать
+inline bool unpackLZ77(const uint8_t *packed, size_t packedSize,
+                       std::string &output) {
+  const uint8_t *src = packed;
+  const uint8_t *end = packed + packedSize;
+  if (src == end || *src > LZ77_HUFFMAN)
+    return false;
+  bool entropy = *src++ == LZ77_HUFFMAN;
+  uint64_t size, tokenCount;
+  if (!readVarint(src, end, size) || !readVarint(src, end, tokenCount) ||
+      tokenCount > size)
+    return false;
+
+  std::vector<uint8_t> commandStorage, literalStorage;
+  const uint8_t *command, *commandEnd, *literal, *literalEnd;
+  if (!readStream(src, end, entropy, commandStorage, command, commandEnd) ||
+      !readStream(src, end, entropy, literalStorage, literal, literalEnd) ||
+      src != end || static_cast<uint64_t>(literalEnd - literal) != tokenCount)
+    return false;
+
+  // Размер из заголовка сверяется с командами, прежде чем выделять под него
+  // память, если степень сжатия подозрительно велика
+  if (size / 64 > packedSize) {
+    const uint8_t *scan = command;
+    uint64_t total = 0;
+    for (uint64_t t = 0; t < tokenCount; ++t) {
+      uint64_t length, offset;
+      if (!readVarint(scan, commandEnd, length) || length >= size - total ||
+          (length > 0 && !readVarint(scan, commandEnd, offset)))
+        return false;
+      total += length + 1;
+    }
+    if (total != size)
+      return false;
+  }
+
+  // Содержимое всё равно перезаписывается, поэтому буфер не обнуляется заново
+  output.resize(size + COPY_SLACK);
+  uint8_t *out = reinterpret_cast<uint8_t *>(&output[0]);
+  uint64_t pos = 0;
+  for (uint64_t t = 0; t < tokenCount; ++t) {
+    uint64_t length, offset;
+    if (!readShortVarint(command, commandEnd, length) || length >= size - pos)
+      return false;
+    if (length > 0) {
+      if (!readShortVarint(command, commandEnd, offset) || offset == 0 ||
+          offset > pos)
+        return false;
+      copyMatch(out + pos, offset, length);
+      pos += length;
+    }
+    out[pos++] = literal[t];
+  }
+  if (pos != size || command != commandEnd)
+    return false;
+  output.resize(size);
+  return true;
+}
+
+inline bool unpackLZ77(const std::vector<uint8_t> &packed,
+                       std::string &output) {
+  return unpackLZ77(packed.data(), packed.size(), output);
+}
+
+// Прежний поиск перебором всех позиций окна, O(n·окно·длина). Совпадение
+// обрывается за символ до конца входа, чтобы nextChar всегда существовал
+inline std::vector<LZ77Token> encodeLZ77BruteForce(const std::string &input,
+                                                   int windowSize) {
+  std::vector<LZ77Token> tokens;
+  int n = static_cast<int>(input.size());
+  int i = 0;
+
+  while (i < n) {
+    int matchLength = 0;
+    int matchOffset = 0;
+
+    // Поиск самой длинной совпадающей подстроки в пределах окна
+    for (int j = std::max(0, i - windowSize); j < i; ++j) {
+      int length = 0;
+      while (i + length < n - 1 && input[j + length] == input[i + length])
+        length++;
+
+      if (length > matchLength) {
+        matchLength = length;
+        matchOffset = i - j;
+      }
+    }
+
+    tokens.push_back({matchOffset, matchLength, input[i + matchLength]});
+    i += matchLength + 1;
+  }
+
+  return tokens;
+}
+
+const int MIN_MATCH = 3;   // Хеш берётся от трёх байтов
+const int GOOD_MATCH = 32;  // После такого совпадения цепочка сокращается вчетверо
+const int NICE_MATCH = 258; // Совпадения длиннее не ищутся дальше по цепочке
+const int HASH_BITS = 16;
+
+// Длина общего префикса двух участков, не больше limit. Сравнение идёт по
+// 8 байтов; участки могут перекрываться, они только читаются
+inline int commonLength(const char *a, const char *b, int limit) {
+  int length = 0;
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+  while (length + 8 <= limit) {
+    uint64_t x, y;
+    std::memcpy(&x, a + length, sizeof(x));
+    std::memcpy(&y, b + length, sizeof(y));
+    if (x != y)
+      return length + __builtin_ctzll(x ^ y) / 8;
+    length += 8;
+  }
+#endif
+  while (length < limit && a[length] == b[length])
+    length++;
+  return length;
+}
+
+// Поиск совпадений по хеш-цепочкам: head хранит последнюю позицию для
+// каждого хеша трёх байтов, prev — предыдущую позицию с тем же хешем.
+// prev — кольцо размером с окно, поэтому память не зависит от длины входа
+class LZ77MatchFinder {
+private:
+  const std::string &input;
+  int n;
+  int windowSize;
+  int maxChainLength;
+  std::vector<int> head;
+  std::vector<int> prev;
+  int mask;
+  int nextInsert = 0;
+
+  uint32_t hashAt(int pos) const {
+    uint32_t value = static_cast<uint8_t>(input[pos]) << 16 |
+                     static_cast<uint8_t>(input[pos + 1]) << 8 |
+                     static_cast<uint8_t>(input[pos + 2]);
+    return (value * 2654435761u) >> (32 - HASH_BITS);
+  }
+
+  // Добавление в цепочки всех позиций до end
+  void insertUntil(int end) {
+    for (; nextInsert < end; ++nextInsert) {
+      if (nextInsert + MIN_MATCH > n)
+        continue;
+      uint32_t h = hashAt(nextInsert);
+      prev[nextInsert & mask] = head[h];
+      head[h] = nextInsert;
+    }
+  }
+
+public:
+  struct Match {
+    int offset;
+    int length;
+  };
+
+  LZ77MatchFinder(const std::string &text, int window, int chainLength)
+      : input(text), n(static_cast<int>(text.size())), windowSize(window),
+        maxChainLength(chainLength), head(1 << HASH_BITS, -1) {
+    int ring = 1;
+    while (ring < window && ring < n)
+      ring <<= 1;
+    prev.assign(ring, -1);
+    mask = ring - 1;
+  }
+
+  // Самое длинное совпадение для позиции pos; позиции вызываются по
+  // возрастанию. Длина оставляет место под nextChar
+  Match find(int pos) {
+    insertUntil(pos);
+    Match best = {0, 0};
+    int limit = n - pos - 1;
+    if (limit < MIN_MATCH)
+      return best;
+
+    const char *current = input.data() + pos;
+    int candidate = head[hashAt(pos)];
+    for (int chain = maxChainLength; candidate >= 0 && chain > 0; --chain) {
+      if (pos - candidate > windowSize)
+        break;
+      const char *earlier = input.data() + candidate;
+      // Кандидат хуже лучшего, если не совпадает уже на его длине
+      if (earlier[best.length] == current[best.length]) {
+        int length = commonLength(earlier, current, limit);
+        if (length > best.length) {
+          if (best.length < GOOD_MATCH && length >= GOOD_MATCH)
+            chain = chain / 4 + 1;
+          best = {pos - candidate, length};
+          if (length >= limit || length >= NICE_MATCH)
+            break;
+        }
+      }
+      int next = prev[candidate & mask];
+      if (next >= candidate) // Запись в кольце уже перезаписана
+        break;
+      candidate = next;
+    }
+    if (best.length < MIN_MATCH)
+      best = {0, 0};
+    return best;
+  }
+};
+
+// Кодирование с поиском по хеш-цепочкам. chainLength ограничивает число
+// проверяемых кандидатов (скорость против степени сжатия). При lazy
+// совпадение откладывается на байт, если со следующей позиции оно длиннее
+inline std::vector<LZ77Token> encodeLZ77(const std::string &input,
+                                         int windowSize, int chainLength = 64,
+                                         bool lazy = false) {
+  std::vector<LZ77Token> tokens;
+  int n = static_cast<int>(input.size());
+  if (n == 0)
+    return tokens;
+  LZ77MatchFinder finder(input, windowSize, chainLength);
+
+  int i = 0;
+  LZ77MatchFinder::Match current = finder.find(0);
+  while (i < n) {
+    if (lazy && current.length > 0 && current.length < NICE_MATCH &&
+        i + 1 < n) {
+      LZ77MatchFinder::Match next = finder.find(i + 1);
+      // Отложенный литерал сам занимает токен, поэтому выигрыш нужен больше байта
+      if (next.length > current.length + 1) {
+        tokens.push_back({0, 0, input[i]});
+        ++i;
+        current = next;
+        continue;
+      }
+    }
+
+    tokens.push_back({current.offset, current.length, input[i + current.length]});
+    i += current.length + 1;
+    if (i < n)
+      current = finder.find(i);
+  }
+
+  return tokens;
+}
+
+#endif // SIAOD_LZ77_H
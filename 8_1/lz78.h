@@ -0,0 +1,383 @@
+// LZ78 на боре фраз и LZW с кодами переменной ширины
+#ifndef SIAOD_LZ78_H
+#define SIAOD_LZ78_H
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+struct LZ78Token {
+  uint32_t index;
+  char nextChar;
+};
+
+// Словарь фраз в виде бора: фраза — ребёнок (номер родителя, байт).
+// Дети ищутся открытой адресацией в плоских массивах, поэтому шаг
+// кодирования стоит O(1) и не зависит от длины фразы
+class PhraseTrie {
+private:
+  // Ключ и номер лежат рядом: поиск стоит одного промаха кэша, а не двух
+  struct Slot {
+    uint32_t parent;
+    uint32_t code; // 0 — свободная ячейка
+    uint8_t byte;
+  };
+
+  std::vector<Slot> slots;
+  uint64_t mask = 0;
+  size_t count = 0;
+
+  static uint64_t slotOf(uint32_t parent, uint8_t byte) {
+    uint64_t key = static_cast<uint64_t>(parent) << 8 | byte;
+    return (key * 0x9E3779B97F4A7C15ull) >> 20;
+  }
+
+  void grow() {
+    std::vector<Slot> old(slots.size() * 2, Slot{0, 0, 0});
+    old.swap(slots);
+    mask = slots.size() - 1;
+    for (const Slot &slot : old) {
+      if (slot.code) {
+        uint64_t index = slotOf(slot.parent, slot.byte) & mask;
+        while (slots[index].code)
+          index = (index + 1) & mask;
+        slots[index] = slot;
+      }
+    }
+  }
+
+public:
+  // capacity — ожидаемое число фраз; при переполнении таблица растёт
+  explicit PhraseTrie(size_t capacity) {
+    size_t size = 1024;
+    while (size < capacity * 2)
+      size <<= 1;
+    slots.assign(size, Slot{0, 0, 0});
+    mask = size - 1;
+  }
+
+  // Номер ребёнка фразы parent по байту или 0, если его нет
+  uint32_t find(uint32_t parent, uint8_t byte) const {
+    for (uint64_t index = slotOf(parent, byte) & mask; slots[index].code;
+         index = (index + 1) & mask) {
+      if (slots[index].parent == parent && slots[index].byte == byte)
+        return slots[index].code;
+    }
+    return 0;
+  }
+
+  void insert(uint32_t parent, uint8_t byte, uint32_t code) {
+    if ((count + 1) * 2 > slots.size())
+      grow();
+    uint64_t index = slotOf(parent, byte) & mask;
+    while (slots[index].code)
+      index = (index + 1) & mask;
+    slots[index] = {parent, code, byte};
+    count++;
+  }
+
+  void clear() {
+    std::fill(slots.begin(), slots.end(), Slot{0, 0, 0});
+    count = 0;
+  }
+};
+
+// Запас в конце вывода: короткие фразы копируются блоком в 16 байтов
+const size_t PHRASE_SLACK = 16;
+
+// Копирование фразы, уже записанной раньше в вывод. Источник может
+// заходить на приёмник (фраза KwKwK в LZW), тогда копируем по байту вперёд
+inline void copyPhrase(uint8_t *out, uint64_t from, uint64_t to,
+                       uint32_t length) {
+  if (length <= 16 && from + length <= to) {
+    // Лишние байты блока перезапишут следующие фразы
+    uint8_t block[16];
+    std::memcpy(block, out + from, 16);
+    std::memcpy(out + to, block, 16);
+  } else if (from + length <= to) {
+    std::memcpy(out + to, out + from, length);
+  } else {
+    for (uint32_t i = 0; i < length; ++i)
+      out[to + i] = out[from + i];
+  }
+}
+
+// Функция кодирования LZ78. Фраза 0 пустая, новые фразы нумеруются с 1;
+// номера 32-битные, поэтому словарь не переполняется после 255 фраз
+inline std::vector<LZ78Token> encodeLZ78(const std::string &input) {
+  PhraseTrie dictionary(input.size() / 4);
+  // Для каждой фразы: родитель и последний байт, чтобы закрыть хвост входа
+  std::vector<uint32_t> parents(1, 0);
+  std::vector<char> lastChars(1, '\0');
+  std::vector<LZ78Token> tokens;
+
+  uint32_t current = 0;
+  for (char c : input) {
+    uint32_t child = dictionary.find(current, static_cast<uint8_t>(c));
+    if (child) {
+      current = child;
+      continue;
+    }
+    // Добавляем фразу и токен (номер известной части, новый символ)
+    uint32_t code = static_cast<uint32_t>(parents.size());
+    dictionary.insert(current, static_cast<uint8_t>(c), code);
+    parents.push_back(current);
+    lastChars.push_back(c);
+    tokens.push_back({current, c});
+    current = 0;
+  }
+
+  // Если после цикла осталась непустая часть строки, она уже есть в словаре:
+  // записываем её как родителя и последний символ
+  if (current != 0) {
+    tokens.push_back({parents[current], lastChars[current]});
+  }
+
+  return tokens;
+}
+
+// Функция декодирования LZ78. Словарь — массивы начала и длины фразы в уже
+// восстановленном тексте: фраза k записана там, где разобран токен k, и
+// копируется оттуда целиком, без промежуточных строк
+inline std::string decodeLZ78(const std::vector<LZ78Token> &tokens) {
+  std::vector<uint64_t> starts(tokens.size() + 1, 0);
+  std::vector<uint32_t> lengths(tokens.size() + 1, 0);
+
+  // Первый проход — длины фраз и размер результата
+  uint64_t total = 0;
+  for (size_t k = 0; k < tokens.size(); ++k) {
+    uint32_t index = tokens[k].index <= k ? tokens[k].index : 0;
+    lengths[k + 1] = lengths[index] + 1;
+    total += lengths[k + 1];
+  }
+
+  std::string decoded(total + PHRASE_SLACK, '\0');
+  uint8_t *out = reinterpret_cast<uint8_t *>(&decoded[0]);
+  uint64_t pos = 0;
+  for (size_t k = 0; k < tokens.size(); ++k) {
+    uint32_t index = tokens[k].index <= k ? tokens[k].index : 0;
+    starts[k + 1] = pos;
+    copyPhrase(out, starts[index], pos, lengths[index]);
+    pos += lengths[index];
+    out[pos++] = static_cast<uint8_t>(tokens[k].nextChar);
+  }
+
+  decoded.resize(total);
+  return decoded;
+}
+
+// LZW с кодами переменной ширины: первые 256 кодов — байты, 256 — сброс
+// словаря, новые фразы нумеруются с 257. Ширина кода растёт с 9 бит до
+// maxBits (до 24) вместе со словарём. Когда словарь заполнен, политика
+// Reset сбрасывает его, а Freeze оставляет как есть
+enum class DictionaryPolicy { Reset, Freeze };
+
+const uint32_t LZW_CLEAR = 256;
+const uint32_t LZW_FIRST = 257;
+const int LZW_MIN_BITS = 9;
+const int LZW_MAX_BITS = 24;
+// Заголовок: maxBits, политика, исходный размер (8 байт)
+const size_t LZW_HEADER = 10;
+
+// Ширина, достаточная для кодов меньше limit
+inline int codeWidth(uint32_t limit) {
+  int width = 32 - __builtin_clz((limit - 1) | 1);
+  return std::max(width, LZW_MIN_BITS);
+}
+
+// Запись кодов младшими битами вперёд через 64-битный буфер
+class BitWriter {
+private:
+  std::vector<uint8_t> &out;
+  uint64_t buffer = 0;
+  int bits = 0;
+
+public:
+  explicit BitWriter(std::vector<uint8_t> &target) : out(target) {}
+
+  void put(uint32_t value, int width) {
+    buffer |= static_cast<uint64_t>(value) << bits;
+    bits += width;
+    while (bits >= 8) {
+      out.push_back(static_cast<uint8_t>(buffer));
+      buffer >>= 8;
+      bits -= 8;
+    }
+  }
+
+  void flush() {
+    if (bits > 0)
+      out.push_back(static_cast<uint8_t>(buffer));
+    buffer = 0;
+    bits = 0;
+  }
+};
+
+inline std::vector<uint8_t>
+lzwCompress(const uint8_t *data, size_t size, int maxBits = 16,
+            DictionaryPolicy policy = DictionaryPolicy::Reset) {
+  maxBits = std::max(LZW_MIN_BITS, std::min(maxBits, LZW_MAX_BITS));
+  const uint32_t maxCode = 1u << maxBits;
+  std::vector<uint8_t> packed(LZW_HEADER);
+  packed[0] = static_cast<uint8_t>(maxBits);
+  packed[1] = policy == DictionaryPolicy::Reset ? 0 : 1;
+  for (int i = 0; i < 8; ++i)
+    packed[2 + i] = static_cast<uint8_t>(static_cast<uint64_t>(size) >> 8 * i);
+  if (size == 0)
+    return packed;
+  packed.reserve(LZW_HEADER + size / 2);
+
+  // Фраз не больше, чем байтов на входе: таблица не занимает сотни мегабайт
+  // при 24-битных кодах на коротком входе
+  PhraseTrie dictionary(std::min<size_t>(maxCode - LZW_FIRST, size));
+  BitWriter writer(packed);
+  uint32_t nextCode = LZW_FIRST;
+  uint32_t current = data[0];
+  for (size_t i = 1; i < size; ++i) {
+    uint32_t child = dictionary.find(current, data[i]);
+    if (child) {
+      current = child;
+      continue;
+    }
+    writer.put(current, codeWidth(nextCode));
+    if (nextCode < maxCode) {
+      dictionary.insert(current, data[i], nextCode++);
+    } else if (policy == DictionaryPolicy::Reset) {
+      writer.put(LZW_CLEAR, codeWidth(nextCode));
+      dictionary.clear();
+      nextCode = LZW_FIRST;
+    }
+    current = data[i];
+  }
+  writer.put(current, codeWidth(nextCode));
+  writer.flush();
+  return packed;
+}
+
+// Чтение кодов младшими битами вперёд; за концом потока идут нули
+class BitReader {
+private:
+  const uint8_t *src;
+  const uint8_t *end;
+  uint64_t buffer = 0;
+  int bits = 0;
+  uint64_t overrun = 0; // Сколько бит прочитано за концом потока
+
+public:
+  BitReader(const uint8_t *begin, const uint8_t *finish)
+      : src(begin), end(finish) {}
+
+  uint32_t get(int width) {
+    while (bits < width) {
+      if (src < end)
+        buffer |= static_cast<uint64_t>(*src++) << bits;
+      else
+        overrun += 8;
+      bits += 8;
+    }
+    uint32_t value = static_cast<uint32_t>(buffer & ((1ull << width) - 1));
+    buffer >>= width;
+    bits -= width;
+    return value;
+  }
+
+  // Не прочитаны ли целые байты, которых нет в потоке
+  bool exhausted() const { return overrun > static_cast<uint64_t>(bits); }
+};
+
+// Распаковка LZW. Новая фраза — предыдущая плюс байт, и в выводе она уже
+// стоит там, где записана предыдущая. Поэтому словарь — массивы начала и
+// длины фразы в выводе, а код распаковывается одним копированием
+inline bool lzwDecompress(const uint8_t *packed, size_t packedSize,
+                          std::vector<uint8_t> &output) {
+  if (packedSize < LZW_HEADER || packed[0] < LZW_MIN_BITS ||
+      packed[0] > LZW_MAX_BITS || packed[1] > 1)
+    return false;
+  const uint32_t maxCode = 1u << packed[0];
+  const bool reset = packed[1] == 0;
+  uint64_t size = 0;
+  for (int i = 0; i < 8; ++i)
+    size |= static_cast<uint64_t>(packed[2 + i]) << (8 * i);
+  // Кодов не больше, чем помещается по 9 бит, а каждый следующий код
+  // длиннее предыдущего не больше чем на байт: k кодов дают до k(k+1)/2
+  uint64_t codes = (packedSize - LZW_HEADER) * 8 / LZW_MIN_BITS + 1;
+  if (codes < (1ull << 31) && size > codes * (codes + 1) / 2)
+    return false;
+
+  // Начало и длина рядом: распаковка кода стоит одного промаха кэша
+  struct Phrase {
+    uint64_t start;
+    uint32_t length;
+  };
+  // Каждый код добавляет не больше одной фразы, поэтому словарь ограничен
+  // числом кодов в потоке, а не шириной кода из заголовка
+  std::vector<Phrase> phrases(
+      std::min<uint64_t>(maxCode, LZW_FIRST + codes + 1));
+
+  // Вывод выделяется сразу целиком, если степень сжатия правдоподобна, иначе
+  // растёт удвоением: повреждённый размер не приведёт к огромному выделению
+  uint64_t capacity = std::min<uint64_t>(size, packedSize * 64);
+  output.resize(capacity + PHRASE_SLACK);
+  uint8_t *out = output.data();
+  BitReader reader(packed + LZW_HEADER, packed + packedSize);
+  uint32_t nextCode = LZW_FIRST;
+  uint64_t previousStart = 0;
+  uint32_t previousLength = 0;
+  bool havePrevious = false;
+  uint64_t pos = 0;
+  while (pos < size) {
+    // Кодер к этому коду уже добавил фразу, которую декодер добавит сейчас
+    uint32_t expected = havePrevious ? std::min(nextCode + 1, maxCode) : nextCode;
+    uint32_t code = reader.get(codeWidth(expected));
+    if (reader.exhausted())
+      return false;
+    if (code == LZW_CLEAR) {
+      if (!reset)
+        return false;
+      nextCode = LZW_FIRST;
+      havePrevious = false;
+      continue;
+    }
+    if (code > nextCode || (code == nextCode && !havePrevious) ||
+        (code >= 256 && code < LZW_FIRST))
+      return false;
+
+    if (havePrevious && nextCode < maxCode) {
+      // Новая фраза: предыдущая плюс первый байт текущей, то есть байт сразу
+      // за предыдущей фразой в выводе. Если текущая и есть новая (KwKwK),
+      // копирование ниже само допишет этот байт
+      phrases[nextCode] = {previousStart, previousLength + 1};
+      nextCode++;
+    } else if (code == nextCode) {
+      return false;
+    }
+
+    uint32_t length = code < 256 ? 1 : phrases[code].length;
+    if (length > size - pos)
+      return false;
+    if (length > capacity - pos) {
+      capacity = std::min(size, std::max(capacity * 2, pos + length));
+      output.resize(capacity + PHRASE_SLACK);
+      out = output.data();
+    }
+    if (code < 256)
+      out[pos] = static_cast<uint8_t>(code);
+    else
+      copyPhrase(out, phrases[code].start, pos, length);
+    previousStart = pos;
+    previousLength = length;
+    pos += length;
+    havePrevious = true;
+  }
+  output.resize(size);
+  return true;
+}
+
+inline bool lzwDecompress(const std::vector<uint8_t> &packed,
+                          std::vector<uint8_t> &output) {
+  return lzwDecompress(packed.data(), packed.size(), output);
+}
+
+#endif // SIAOD_LZ78_H
@@ -0,0 +1,30 @@
+// Тестовый текст для замеров кодеков 8_1
+#ifndef SIAOD_SAMPLE_TEXT_H
+#define SIAOD_SAMPLE_TEXT_H
+
+#include <random>
+#include <string>
+#include <vector>
+
+// Текст из слов случайного словаря; частые слова встречаются чаще
+inline std::string generateText(size_t size, unsigned seed) {
+  std::mt19937 rng(seed);
+  std::vector<std::string> words(2000);
+  for (auto &word : words) {
+    int length = 2 + rng() % 8;
+    for (int k = 0; k < length; ++k)
+      word += static_cast<char>('a' + rng() % 26);
+  }
+  std::string text;
+  text.reserve(size + 16);
+  while (text.size() < size) {
+    // Квадрат равномерного числа смещает выбор к началу словаря
+    double u = std::uniform_real_distribution<double>(0, 1)(rng);
+    text += words[static_cast<size_t>(u * u * words.size())];
+    text += rng() % 10 ? ' ' : '\n';
+  }
+  text.resize(size);
+  return text;
+}
+
+#endif // SIAOD_SAMPLE_TEXT_H
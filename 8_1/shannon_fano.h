@@ -0,0 +1,88 @@
+// Код Шеннона — Фано над байтами. Длины кодов строятся делением списка
+// символов, а упаковка и декодирование общие с каноническим кодом Хаффмана
+#ifndef SIAOD_SHANNON_FANO_H
+#define SIAOD_SHANNON_FANO_H
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+#include "huffman.h"
+
+// Длины кодов по частотам. Символы сортируются по убыванию частоты, и
+// отрезок делится там, где левая часть впервые набирает половину веса.
+// Веса отрезков берутся из префиксных сумм, а точка деления ищется
+// двоичным поиском, поэтому построение стоит O(n log n). Деление идёт по
+// явному стеку отрезков, глубина рекурсии не растёт
+inline void buildShannonFanoLengths(const uint32_t freq[256],
+                                    uint8_t lengths[256]) {
+  std::fill(lengths, lengths + 256, 0);
+  // Ключ — дополнение частоты и байт: сортировка чисел по возрастанию даёт
+  // убывание частоты, а при равных частотах меньший байт идёт раньше
+  uint64_t keys[256];
+  int count = 0;
+  for (int s = 0; s < 256; ++s) {
+    if (freq[s])
+      keys[count++] = static_cast<uint64_t>(UINT32_MAX - freq[s]) << 8 | s;
+  }
+  if (count == 0)
+    return;
+  if (count == 1) {
+    lengths[keys[0] & 255] = 1;
+    return;
+  }
+  std::sort(keys, keys + count);
+  uint8_t symbols[256];
+  for (int i = 0; i < count; ++i)
+    symbols[i] = static_cast<uint8_t>(keys[i]);
+  // prefix[i] — суммарная частота первых i символов; частоты не нулевые,
+  // поэтому суммы строго растут
+  uint64_t prefix[257];
+  prefix[0] = 0;
+  for (int i = 0; i < count; ++i)
+    prefix[i + 1] = prefix[i] + freq[symbols[i]];
+
+  struct Range {
+    int start, end, depth;
+  };
+  Range stack[256];
+  int top = 0;
+  stack[top++] = {0, count - 1, 0};
+  while (top > 0) {
+    Range range = stack[--top];
+    if (range.start == range.end) {
+      // Глубина до 255 умещается в байт, лишнее срежет limitCodeLengths
+      lengths[symbols[range.start]] = static_cast<uint8_t>(range.depth);
+      continue;
+    }
+
+    // Первый i, при котором символы start..i набирают половину веса
+    uint64_t total = prefix[range.end + 1] - prefix[range.start];
+    const uint64_t *split =
+        std::lower_bound(prefix + range.start + 1, prefix + range.end + 1,
+                         prefix[range.start] + total / 2);
+    int splitIndex = split == prefix + range.end + 1
+                         ? range.start
+                         : static_cast<int>(split - prefix) - 1;
+    stack[top++] = {range.start, splitIndex, range.depth + 1};
+    stack[top++] = {splitIndex + 1, range.end, range.depth + 1};
+  }
+
+  // limitCodeLengths ждёт символы по возрастанию частоты
+  std::reverse(symbols, symbols + count);
+  limitCodeLengths(lengths, symbols, count);
+}
+
+// Формат совпадает с huffmanCompress, распаковывает huffmanDecompress
+inline std::vector<uint8_t> shannonFanoCompress(const uint8_t *data,
+                                                size_t size) {
+  if (size > MAX_ENTROPY_INPUT)
+    return {};
+  uint32_t freq[256];
+  countFrequencies(data, size, freq);
+  uint8_t lengths[256];
+  buildShannonFanoLengths(freq, lengths);
+  return canonicalCompress(data, size, freq, lengths);
+}
+
+#endif // SIAOD_SHANNON_FANO_H
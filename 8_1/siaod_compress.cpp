@@ -0,0 +1,129 @@
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+#include "compress.h"
+
+void printUsage(const char *program) {
+  std::cerr << "Использование:\n  " << program
+            << " compress [-c кодек] [-b размер_блока_КБ] [-t потоки] [-v] "
+               "вход выход\n  "
+            << program << " decompress [-t потоки] [-v] вход выход\n"
+            << "Кодеки: auto, huffman, shannon-fano, tans, lz77, lzw, stored.\n"
+            << "Вместо имени файла \"-\" — стандартный ввод или вывод"
+            << std::endl;
+}
+
+// Файл по имени из командной строки; "-" — стандартный поток
+FILE *openFile(const std::string &name, bool output) {
+  if (name == "-")
+    return output ? stdout : stdin;
+  return std::fopen(name.c_str(), output ? "wb" : "rb");
+}
+
+void printStats(const StreamStats &stats, double seconds) {
+  std::cerr << "Исходных данных: " << stats.rawBytes << " байт, сжатых: "
+            << stats.packedBytes << " байт";
+  if (stats.rawBytes > 0)
+    std::cerr << " (" << 100.0 * stats.packedBytes / stats.rawBytes << "%)";
+  std::cerr << ", " << stats.rawBytes / (1024.0 * 1024.0) / seconds
+            << " МБ/с" << std::endl
+            << "Блоки:";
+  for (int c = 0; c < CODEC_COUNT; ++c) {
+    if (stats.blocks[c])
+      std::cerr << " " << codecName(static_cast<Codec>(c)) << " "
+                << stats.blocks[c];
+  }
+  std::cerr << std::endl;
+}
+
+int main(int argc, char *argv[]) {
+  if (argc < 2) {
+    printUsage(argv[0]);
+    return 1;
+  }
+  std::string mode = argv[1];
+  if (mode != "compress" && mode != "decompress") {
+    printUsage(argv[0]);
+    return 1;
+  }
+
+  Codec codec = Codec::Auto;
+  size_t blockSize = DEFAULT_BLOCK_SIZE;
+  int threads = static_cast<int>(defaultThreads());
+  bool verbose = false;
+  std::string files[2];
+  int fileCount = 0;
+  for (int i = 2; i < argc; ++i) {
+    std::string option = argv[i];
+    if (option == "-c" && i + 1 < argc && mode == "compress") {
+      if (!parseCodec(argv[++i], codec)) {
+        std::cerr << "Неизвестный кодек: " << argv[i] << std::endl;
+        return 1;
+      }
+    } else if (option == "-b" && i + 1 < argc && mode == "compress") {
+      long kilobytes = std::strtol(argv[++i], nullptr, 10);
+      if (kilobytes <= 0 ||
+          static_cast<size_t>(kilobytes) > MAX_BLOCK_SIZE / 1024) {
+        std::cerr << "Размер блока от 1 до " << MAX_BLOCK_SIZE / 1024
+                  << " КБ" << std::endl;
+        return 1;
+      }
+      blockSize = static_cast<size_t>(kilobytes) * 1024;
+    } else if (option == "-t" && i + 1 < argc) {
+      threads = std::atoi(argv[++i]);
+      if (threads < 1 || threads > 256) {
+        std::cerr << "Число потоков от 1 до 256" << std::endl;
+        return 1;
+      }
+    } else if (option == "-v") {
+      verbose = true;
+    } else if (fileCount < 2 && (option == "-" || option[0] != '-')) {
+      files[fileCount++] = option;
+    } else {
+      printUsage(argv[0]);
+      return 1;
+    }
+  }
+  if (fileCount != 2) {
+    printUsage(argv[0]);
+    return 1;
+  }
+
+  FILE *in = openFile(files[0], false);
+  if (!in) {
+    std::cerr << "Не удалось открыть " << files[0] << std::endl;
+    return 1;
+  }
+  FILE *out = openFile(files[1], true);
+  if (!out) {
+    std::cerr << "Не удалось создать " << files[1] << std::endl;
+    if (in != stdin)
+      std::fclose(in);
+    return 1;
+  }
+
+  StreamStats stats;
+  auto start = std::chrono::high_resolution_clock::now();
+  bool ok = mode == "compress"
+                ? compressStream(in, out, codec, blockSize, threads, &stats)
+                : decompressStream(in, out, threads, &stats);
+  if (in != stdin)
+    std::fclose(in);
+  if (out != stdout && std::fclose(out) != 0)
+    ok = false;
+
+  if (!ok) {
+    std::cerr << (mode == "compress" ? "Ошибка чтения или записи"
+                                     : "Поток повреждён или не дописан")
+              << std::endl;
+    return 1;
+  }
+  std::chrono::duration<double> time =
+      std::chrono::high_resolution_clock::now() - start;
+  if (verbose)
+    printStats(stats, time.count());
+  return 0;
+}
@@ -0,0 +1,399 @@
+// Табличная система асимметричных чисел (tANS, как в FSE). Частоты байтов
+// нормируются к таблице в 2^12 состояний, поэтому символ обходится дробным
+// числом бит, а не целым, как в коде Хаффмана. Четыре состояния чередуются
+// по символам и делят один поток бит: соседние символы декодируются
+// независимо, и процессор выполняет их поиск в таблице параллельно
+#ifndef SIAOD_TANS_H
+#define SIAOD_TANS_H
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#include "huffman.h"
+
+const int TANS_TABLE_LOG = 12;
+const uint32_t TANS_TABLE_SIZE = 1u << TANS_TABLE_LOG;
+const int TANS_STATES = 4;
+// Заголовок: исходный размер (8 байт), битовая маска встречающихся байтов
+// (32 байта), затем нормированные частоты этих байтов по 2 байта
+const size_t TANS_HEADER = 40;
+
+inline int highBit(uint32_t value) { return 31 - __builtin_clz(value); }
+
+// Частоты, приведённые к сумме TANS_TABLE_SIZE; у встречающегося байта не
+// меньше 1. Ошибку округления забирает самый частый байт, а если её
+// слишком много, лишнее снимается с самых больших долей
+inline void normalizeFrequencies(const uint32_t freq[256], uint64_t total,
+                                 uint16_t norm[256]) {
+  uint32_t sum = 0;
+  int largest = 0;
+  for (int s = 0; s < 256; ++s) {
+    norm[s] = 0;
+    if (!freq[s])
+      continue;
+    uint64_t scaled = (static_cast<uint64_t>(freq[s]) * TANS_TABLE_SIZE +
+                       total / 2) / total;
+    norm[s] = static_cast<uint16_t>(std::max<uint64_t>(scaled, 1));
+    sum += norm[s];
+    if (freq[s] > freq[largest])
+      largest = s;
+  }
+  if (sum < TANS_TABLE_SIZE) {
+    norm[largest] += TANS_TABLE_SIZE - sum;
+    sum = TANS_TABLE_SIZE;
+  }
+  while (sum > TANS_TABLE_SIZE) {
+    norm[std::max_element(norm, norm + 256) - norm]--;
+    sum--;
+  }
+}
+
+// Раскладка символов по состояниям: шаг взаимно прост с размером таблицы,
+// поэтому каждое состояние занято ровно один раз, а состояния одного
+// символа разбросаны по всей таблице
+inline void spreadSymbols(const uint16_t norm[256],
+                          uint8_t spread[TANS_TABLE_SIZE]) {
+  const uint32_t step = (TANS_TABLE_SIZE >> 1) + (TANS_TABLE_SIZE >> 3) + 3;
+  uint32_t position = 0;
+  for (int s = 0; s < 256; ++s) {
+    for (uint32_t k = 0; k < norm[s]; ++k) {
+      spread[position] = static_cast<uint8_t>(s);
+      position = (position + step) & (TANS_TABLE_SIZE - 1);
+    }
+  }
+}
+
+// Кодер: состояние из [L, 2L), L = TANS_TABLE_SIZE. Число выводимых бит и
+// следующее состояние получаются сложением и сдвигом, без ветвлений
+class TansEncoder {
+private:
+  struct Transform {
+    uint32_t deltaNbBits;
+    int32_t deltaFindState;
+  };
+  uint16_t stateTable[TANS_TABLE_SIZE];
+  Transform transforms[256];
+
+public:
+  void build(const uint16_t norm[256]) {
+    uint8_t spread[TANS_TABLE_SIZE];
+    spreadSymbols(norm, spread);
+    uint32_t cumulative[256], next[256];
+    uint32_t total = 0;
+    for (int s = 0; s < 256; ++s) {
+      cumulative[s] = next[s] = total;
+      total += norm[s];
+    }
+    for (uint32_t u = 0; u < TANS_TABLE_SIZE; ++u)
+      stateTable[next[spread[u]]++] =
+          static_cast<uint16_t>(TANS_TABLE_SIZE + u);
+
+    for (int s = 0; s < 256; ++s) {
+      uint32_t count = norm[s];
+      if (count == 0) {
+        transforms[s] = {0, 0};
+      } else if (count == 1) {
+        transforms[s] = {(TANS_TABLE_LOG << 16) - TANS_TABLE_SIZE,
+                         static_cast<int32_t>(cumulative[s]) - 1};
+      } else {
+        uint32_t maxBitsOut = TANS_TABLE_LOG - highBit(count - 1);
+        uint32_t minStatePlus = count << maxBitsOut;
+        transforms[s] = {(maxBitsOut << 16) - minStatePlus,
+                         static_cast<int32_t>(cumulative[s] - count)};
+      }
+    }
+  }
+
+  // Кодирование символа: младшие nbBits бит состояния уходят в поток
+  uint32_t encode(uint32_t state, uint8_t symbol, uint32_t &bits,
+                  int &nbBits) const {
+    const Transform &t = transforms[symbol];
+    nbBits = static_cast<int>((state + t.deltaNbBits) >> 16);
+    bits = state & ((1u << nbBits) - 1);
+    return stateTable[static_cast<int32_t>(state >> nbBits) +
+                      t.deltaFindState];
+  }
+};
+
+// Декодер: состояние из [0, L) — индекс записи с символом, числом бит и
+// базой следующего состояния
+class TansDecoder {
+public:
+  struct Entry {
+    uint16_t newState;
+    uint8_t symbol;
+    uint8_t nbBits;
+  };
+  Entry table[TANS_TABLE_SIZE];
+
+  void build(const uint16_t norm[256]) {
+    uint8_t spread[TANS_TABLE_SIZE];
+    spreadSymbols(norm, spread);
+    uint32_t next[256];
+    for (int s = 0; s < 256; ++s)
+      next[s] = norm[s];
+    for (uint32_t u = 0; u < TANS_TABLE_SIZE; ++u) {
+      uint8_t s = spread[u];
+      uint32_t x = next[s]++;
+      int nbBits = TANS_TABLE_LOG - highBit(x);
+      table[u] = {static_cast<uint16_t>((x << nbBits) - TANS_TABLE_SIZE), s,
+                  static_cast<uint8_t>(nbBits)};
+    }
+  }
+};
+
+// Запись 8 байтов, младший байт первым
+inline void storeLittleEndian64(uint8_t *dst, uint64_t value) {
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+  std::memcpy(dst, &value, sizeof(value));
+#else
+  for (int i = 0; i < 8; ++i)
+    dst[i] = static_cast<uint8_t>(value >> (8 * i));
+#endif
+}
+
+// Чтение потока с конца: кодер пишет младшими битами вперёд, а декодер
+// забирает последние записанные биты первыми. Байты перед началом потока
+// читаются как нули, поэтому повреждённый поток не выводит чтение за буфер
+class TansBitReader {
+private:
+  const uint8_t *begin;
+  int64_t position; // Смещение восьми загруженных байтов, бывает меньше 0
+  uint64_t container = 0;
+  uint32_t consumed = 0; // Сколько старших бит контейнера уже прочитано
+
+  uint64_t load() const {
+    if (position >= 0)
+      return loadLittleEndian64(begin + position);
+    uint8_t bytes[8] = {0};
+    if (position > -8)
+      std::memcpy(bytes - position, begin, static_cast<size_t>(8 + position));
+    return loadLittleEndian64(bytes);
+  }
+
+public:
+  // Последний байт содержит единичный бит-ограничитель над данными
+  bool open(const uint8_t *data, size_t size) {
+    if (size == 0 || data[size - 1] == 0)
+      return false;
+    begin = data;
+    position = static_cast<int64_t>(size) - 8;
+    container = load();
+    consumed = __builtin_clzll(container) + 1;
+    return true;
+  }
+
+  // nbBits от 0 до TANS_TABLE_LOG; сдвиг в два шага корректен и для нуля
+  uint32_t read(int nbBits) {
+    uint32_t value =
+        static_cast<uint32_t>(((container << consumed) >> 1) >> (63 - nbBits));
+    consumed += nbBits;
+    return value;
+  }
+
+  // После перезагрузки в контейнере не меньше 57 непрочитанных бит
+  void reload() {
+    position -= consumed >> 3;
+    consumed &= 7;
+    container = load();
+  }
+
+  // Сколько бит потока осталось; меньше нуля — прочитано лишнее
+  int64_t remaining() const { return position * 8 + 64 - consumed; }
+};
+
+// Пустой результат — вход длиннее MAX_ENTROPY_INPUT, как у Хаффмана
+inline std::vector<uint8_t> tansCompress(const uint8_t *data, size_t size) {
+  if (size > MAX_ENTROPY_INPUT)
+    return {};
+  uint32_t freq[256];
+  countFrequencies(data, size, freq);
+  std::vector<uint8_t> packed(TANS_HEADER);
+  uint64_t originalSize = size;
+  for (int i = 0; i < 8; ++i)
+    packed[i] = static_cast<uint8_t>(originalSize >> (8 * i));
+  if (size == 0)
+    return packed;
+
+  uint16_t norm[256];
+  normalizeFrequencies(freq, size, norm);
+  for (int s = 0; s < 256; ++s) {
+    if (norm[s]) {
+      packed[8 + s / 8] |= static_cast<uint8_t>(1 << (s & 7));
+      packed.push_back(static_cast<uint8_t>(norm[s]));
+      packed.push_back(static_cast<uint8_t>(norm[s] >> 8));
+    }
+  }
+  TansEncoder encoder;
+  encoder.build(norm);
+
+  // Символ с долей norm стоит не больше TANS_TABLE_LOG - highBit(norm) + 1
+  // бит; 8 байтов запаса под запись контейнера целиком
+  uint64_t maxBits = TANS_STATES * TANS_TABLE_LOG + 1;
+  for (int s = 0; s < 256; ++s) {
+    if (norm[s])
+      maxBits += static_cast<uint64_t>(freq[s]) *
+                 (TANS_TABLE_LOG - highBit(norm[s]) + 1);
+  }
+  size_t header = packed.size();
+  packed.resize(header + maxBits / 8 + 16);
+  uint8_t *dst = packed.data() + header;
+  uint64_t buffer = 0;
+  int bits = 0;
+  auto put = [&](uint32_t value, int nbBits) {
+    buffer |= static_cast<uint64_t>(value) << bits;
+    bits += nbBits;
+  };
+  // Сброс целых байтов без ветвлений: контейнер пишется целиком, указатель
+  // сдвигается на записанные байты. Между сбросами добавляется не больше
+  // 49 бит, поэтому контейнер не переполняется
+  auto flush = [&]() {
+    storeLittleEndian64(dst, buffer);
+    dst += bits >> 3;
+    buffer >>= bits & ~7;
+    bits &= 7;
+  };
+
+  // Кодирование идёт с конца: символ i кодирует состояние i % 4
+  uint32_t state[TANS_STATES];
+  for (int lane = 0; lane < TANS_STATES; ++lane)
+    state[lane] = TANS_TABLE_SIZE;
+  size_t i = size;
+  uint32_t value;
+  int nbBits;
+  for (; i % TANS_STATES != 0; --i) {
+    uint32_t &lane = state[(i - 1) % TANS_STATES];
+    lane = encoder.encode(lane, data[i - 1], value, nbBits);
+    put(value, nbBits);
+  }
+  flush();
+  for (; i > 0; i -= TANS_STATES) {
+    state[3] = encoder.encode(state[3], data[i - 1], value, nbBits);
+    put(value, nbBits);
+    state[2] = encoder.encode(state[2], data[i - 2], value, nbBits);
+    put(value, nbBits);
+    state[1] = encoder.encode(state[1], data[i - 3], value, nbBits);
+    put(value, nbBits);
+    state[0] = encoder.encode(state[0], data[i - 4], value, nbBits);
+    put(value, nbBits);
+    flush();
+  }
+
+  // Конечные состояния, первым прочитается состояние 0, и ограничитель
+  for (int lane = TANS_STATES - 1; lane >= 0; --lane)
+    put(state[lane] - TANS_TABLE_SIZE, TANS_TABLE_LOG);
+  put(1, 1);
+  flush();
+  if (bits > 0)
+    *dst++ = static_cast<uint8_t>(buffer);
+  packed.resize(dst - packed.data());
+  return packed;
+}
+
+inline bool tansDecompress(const uint8_t *packed, size_t size,
+                           std::vector<uint8_t> &output) {
+  if (size < TANS_HEADER)
+    return false;
+  uint64_t originalSize = 0;
+  for (int i = 0; i < 8; ++i)
+    originalSize |= static_cast<uint64_t>(packed[i]) << (8 * i);
+  if (originalSize == 0) {
+    output.clear();
+    return size == TANS_HEADER;
+  }
+
+  uint16_t norm[256];
+  const uint8_t *src = packed + TANS_HEADER;
+  const uint8_t *end = packed + size;
+  uint32_t sum = 0;
+  for (int s = 0; s < 256; ++s) {
+    norm[s] = 0;
+    if (packed[8 + s / 8] >> (s & 7) & 1) {
+      if (end - src < 2)
+        return false;
+      norm[s] = static_cast<uint16_t>(src[0] | src[1] << 8);
+      src += 2;
+      if (norm[s] == 0 || norm[s] > TANS_TABLE_SIZE)
+        return false;
+      sum += norm[s];
+    }
+  }
+  TansBitReader reader;
+  if (sum != TANS_TABLE_SIZE || !reader.open(src, end - src))
+    return false;
+  // В среднем символ стоит не меньше log2(L / maxNorm) >= (L - maxNorm) / L
+  // бит, отсюда предел размера по длине потока. Поток из одного символа
+  // не стоит ничего, и его размер, как у кодирования серий, не ограничен:
+  // контейнер сверяет его с размером блока
+  uint32_t maxNorm = *std::max_element(norm, norm + 256);
+  if (maxNorm < TANS_TABLE_SIZE &&
+      originalSize > (static_cast<uint64_t>(end - src) * 8 + 64) *
+                             TANS_TABLE_SIZE / (TANS_TABLE_SIZE - maxNorm) +
+                         TANS_STATES)
+    return false;
+  TansDecoder decoder;
+  decoder.build(norm);
+  const TansDecoder::Entry *table = decoder.table;
+
+  uint32_t state[TANS_STATES];
+  for (int lane = 0; lane < TANS_STATES; ++lane)
+    state[lane] = reader.read(TANS_TABLE_LOG);
+  reader.reload();
+
+  // Предел выше грубый: частый символ стоит доли бита. Поэтому вывод растёт
+  // удвоением, начиная с 64-кратной степени сжатия, и повреждённый размер
+  // обрывается на нехватке бит, а не на огромном выделении
+  uint64_t capacity = std::min<uint64_t>(originalSize, size * 64);
+  output.resize(capacity);
+  uint64_t pos = 0;
+  while (true) {
+    uint8_t *out = output.data();
+    // Четыре символа на перезагрузку: по 12 бит максимум, 48 из 57
+    for (; pos + TANS_STATES <= capacity; pos += TANS_STATES) {
+      TansDecoder::Entry e0 = table[state[0]];
+      TansDecoder::Entry e1 = table[state[1]];
+      TansDecoder::Entry e2 = table[state[2]];
+      TansDecoder::Entry e3 = table[state[3]];
+      out[pos] = e0.symbol;
+      out[pos + 1] = e1.symbol;
+      out[pos + 2] = e2.symbol;
+      out[pos + 3] = e3.symbol;
+      state[0] = e0.newState + reader.read(e0.nbBits);
+      state[1] = e1.newState + reader.read(e1.nbBits);
+      state[2] = e2.newState + reader.read(e2.nbBits);
+      state[3] = e3.newState + reader.read(e3.nbBits);
+      reader.reload();
+    }
+    if (reader.remaining() < 0)
+      return false;
+    if (capacity == originalSize)
+      break;
+    capacity = std::min(originalSize, capacity * 2);
+    output.resize(capacity);
+  }
+  for (; pos < originalSize; ++pos) {
+    uint32_t &lane = state[pos % TANS_STATES];
+    TansDecoder::Entry e = table[lane];
+    output[pos] = e.symbol;
+    lane = e.newState + reader.read(e.nbBits);
+    reader.reload();
+  }
+
+  // Декодер возвращается в начальные состояния кодера и читает поток
+  // ровно до первого бита
+  for (int lane = 0; lane < TANS_STATES; ++lane) {
+    if (state[lane] != 0)
+      return false;
+  }
+  output.resize(originalSize);
+  return reader.remaining() == 0;
+}
+
+inline bool tansDecompress(const std::vector<uint8_t> &packed,
+                           std::vector<uint8_t> &output) {
+  return tansDecompress(packed.data(), packed.size(), output);
+}
+
+#endif // SIAOD_TANS_H
@@ -1,7 +1,7 @@
 #include <algorithm>
 #include <chrono>
+#include <cstdint>
 #include <iostream>
-#include <unordered_map>
 #include <vector>
 
 enum Direction { NORTH = 0, EAST = 1, SOUTH = 2, WEST = 3 };
@@ -11,92 +11,146 @@ class Castle
 private:
     int rows;
     int cols;
-    std::vector<std::vector<int>> walls; // Хранение стен в виде битовой маски
-    std::vector<std::vector<bool>> visited; // Для обхода при подсчёте комнат
-    std::vector<std::vector<int>> roomIds; // Идентификаторы комнат
-    std::unordered_map<int, int> roomSizes; // Размеры комнат
+    // Клетки нумеруются построчно: клетка (x, y) имеет номер x * cols + y.
+    // Каждая стена принадлежит клетке сверху или слева от неё, поэтому у
+    // клетки хранятся только южная и восточная стены — по 2 бита, четыре
+    // клетки в байте. Внешние стены есть всегда и не хранятся
+    std::vector<uint8_t> walls;
+    // Идентификаторы комнат. Во время разметки здесь же хранится лес системы
+    // непересекающихся множеств
+    std::vector<int> roomIds;
+    std::vector<int> roomSizes; // Площадь комнаты по её номеру
 
-    const int dx[4] = {-1, 0, 1, 0};
-    const int dy[4] = {0, 1, 0, -1};
+    static const int EAST_WALL = 1;
+    static const int SOUTH_WALL = 2;
 
-    int currentRoomId = 0;
-
-public:
-    Castle(const int m, const int n) : rows(m), cols(n)
+    int wallBits(const int cell) const
     {
-        walls.resize(rows, std::vector<int>(cols, 0));
-        visited.resize(rows, std::vector<bool>(cols, false));
-        roomIds.resize(rows, std::vector<int>(cols, -1));
+        return walls[cell >> 2] >> ((cell & 3) * 2) & 3;
     }
 
-    void setWall(const int x, const int y, const Direction dir)
+    // Корень множества клетки со сжатием пути половинным делением
+    int findRoot(int cell)
     {
-        walls[x][y] |= (1 << dir);
-        const int nx = x + dx[dir];
-        const int ny = y + dy[dir];
-        if (nx >= 0 && nx < rows && ny >= 0 && ny < cols)
+        while (roomIds[cell] != cell)
         {
-            walls[nx][ny] |= (1 << ((dir + 2) % 4));
+            roomIds[cell] = roomIds[roomIds[cell]];
+            cell = roomIds[cell];
         }
+        return cell;
     }
 
-    bool hasWall(const int x, const int y, const Direction dir) const
+public:
+    Castle(const int m, const int n) : rows(m), cols(n)
     {
-        return walls[x][y] & (1 << dir);
+        const size_t cells = static_cast<size_t>(rows) * cols;
+        walls.resize((cells + 3) / 4, 0);
+        roomIds.resize(cells, -1);
     }
 
-    int countArea(const int x, const int y)
+    void setWall(int x, int y, const Direction dir)
     {
-        if (x < 0 || x >= rows || y < 0 || y >= cols || visited[x][y])
+        // Северная и западная стены — это южная и восточная стены соседа
+        if (dir == NORTH)
         {
-            return 0;
+            --x;
         }
-
-        visited[x][y] = true;
-        roomIds[x][y] = currentRoomId;
-        int area = 1;
-
-        for (int dir = 0; dir < 4; ++dir)
+        else if (dir == WEST)
         {
-            const int nx = x + dx[dir];
-            const int ny = y + dy[dir];
-            if (nx >= 0 && nx < rows && ny >= 0 && ny < cols &&
-                !hasWall(x, y, static_cast<Direction>(dir)))
-            {
-                area += countArea(nx, ny);
-            }
+            --y;
         }
+        const bool south = dir == NORTH || dir == SOUTH;
+        if (x < 0 || y < 0 || (south ? x + 1 >= rows : y + 1 >= cols))
+        {
+            return;
+        }
+        const int cell = x * cols + y;
+        walls[cell >> 2] |= (south ? SOUTH_WALL : EAST_WALL) << ((cell & 3) * 2);
+    }
 
-        return area;
+    bool hasWall(const int x, const int y, const Direction dir) const
+    {
+        switch (dir)
+        {
+        case NORTH:
+            return x == 0 || wallBits((x - 1) * cols + y) & SOUTH_WALL;
+        case EAST:
+            return y == cols - 1 || wallBits(x * cols + y) & EAST_WALL;
+        case SOUTH:
+            return x == rows - 1 || wallBits(x * cols + y) & SOUTH_WALL;
+        case WEST:
+            return y == 0 || wallBits(x * cols + y - 1) & EAST_WALL;
+        }
+        return true;
     }
 
+    // Разметка комнат в два прохода без рекурсии. Первый проход по строкам
+    // соединяет клетку с верхней и левой соседкой, если между ними нет
+    // стены; корнем множества всегда становится клетка с меньшим номером.
+    // Поэтому ссылки ведут только назад, и второй проход в том же порядке
+    // находит номер комнаты у уже размеченной клетки, на которую ссылается
     void findRooms(int& roomCount, int& maxArea)
     {
-        visited.assign(rows, std::vector<bool>(cols, false));
-        roomSizes.clear();
-        currentRoomId = 0;
-        roomCount = 0;
-        maxArea = 0;
-
         for (int i = 0; i < rows; ++i)
         {
             for (int j = 0; j < cols; ++j)
             {
-                if (roomIds[i][j] == -1)
+                const int cell = i * cols + j;
+                int root = cell;
+                if (i > 0 && !(wallBits(cell - cols) & SOUTH_WALL))
                 {
-                    currentRoomId++;
-                    int area = countArea(i, j);
-                    roomSizes[currentRoomId] = area;
-                    roomCount++;
-                    maxArea = std::max(maxArea, area);
+                    root = findRoot(cell - cols);
                 }
+                if (j > 0 && !(wallBits(cell - 1) & EAST_WALL))
+                {
+                    const int left = findRoot(cell - 1);
+                    if (left < root)
+                    {
+                        if (root != cell)
+                        {
+                            roomIds[root] = left;
+                        }
+                        root = left;
+                    }
+                    else if (left > root)
+                    {
+                        roomIds[left] = root;
+                    }
+                }
+                roomIds[cell] = root;
+            }
+        }
+
+        roomSizes.clear();
+        for (int cell = 0; cell < rows * cols; ++cell)
+        {
+            const int parent = roomIds[cell];
+            if (parent == cell)
+            {
+                roomIds[cell] = static_cast<int>(roomSizes.size());
+                roomSizes.push_back(0);
             }
+            else
+            {
+                roomIds[cell] = roomIds[parent];
+            }
+            roomSizes[roomIds[cell]]++;
+        }
+
+        roomCount = static_cast<int>(roomSizes.size());
+        maxArea = 0;
+        for (const int area : roomSizes)
+        {
+            maxArea = std::max(maxArea, area);
         }
     }
 
+    // Каждая внутренняя стена — южная или восточная стена ровно одной
+    // клетки, поэтому достаточно одного прохода по клеткам подряд: стены,
+    // номера комнат текущей строки и строки под ней читаются линейно
     void findBestWallToRemove(int& maxCombinedArea,
                               std::pair<int, int>& wallPosition,
-                              Direction& bestDir)
+                              Direction& bestDir) const
     {
         maxCombinedArea = 0;
 
@@ -104,27 +158,30 @@ public:
         {
             for (int j = 0; j < cols; ++j)
             {
-                for (int dir = 0; dir < 4; ++dir)
+                const int cell = i * cols + j;
+                const int bits = wallBits(cell);
+                if (!bits)
                 {
-                    const int nx = i + dx[dir];
-                    const int ny = j + dy[dir];
-
-                    if (nx >= 0 && nx < rows && ny >= 0 && ny < cols &&
-                        hasWall(i, j, static_cast<Direction>(dir)))
+                    continue;
+                }
+                const int room = roomIds[cell];
+                const int area = roomSizes[room];
+                for (const Direction dir : {EAST, SOUTH})
+                {
+                    if (!(bits & (dir == EAST ? EAST_WALL : SOUTH_WALL)))
                     {
-                        int room1 = roomIds[i][j];
-                        int room2 = roomIds[nx][ny];
-
-                        if (room1 != room2)
+                        continue;
+                    }
+                    const int other = roomIds[dir == EAST ? cell + 1 : cell + cols];
+                    if (other != room)
+                    {
+                        // Если комнаты разные
+                        const int combinedArea = area + roomSizes[other];
+                        if (combinedArea > maxCombinedArea)
                         {
-                            // Если комнаты разные
-                            const int combinedArea = roomSizes[room1] + roomSizes[room2];
-                            if (combinedArea > maxCombinedArea)
-                            {
-                                maxCombinedArea = combinedArea;
-                                wallPosition = {i, j};
-                                bestDir = static_cast<Direction>(dir);
-                            }
+                            maxCombinedArea = combinedArea;
+                            wallPosition = {i, j};
+                            bestDir = dir;
                         }
                     }
                 }
@@ -226,5 +283,27 @@ int main()
     std::cout << "\nПланировка замка:\n";
     castle.printLayout();
 
+    // Змейка 4000x4000: одна комната на 16 миллионов клеток, которую
+    // рекурсивный обход не переживал из-за переполнения стека
+    const int size = 4000;
+    Castle snake(size, size);
+    for (int i = 0; i + 1 < size; ++i)
+    {
+        for (int j = 0; j < size; ++j)
+        {
+            if (j != (i % 2 ? 0 : size - 1))
+            {
+                snake.setWall(i, j, SOUTH);
+            }
+        }
+    }
+    const auto snakeStart = std::chrono::high_resolution_clock::now();
+    snake.findRooms(roomCount, maxArea);
+    const auto snakeEnd = std::chrono::high_resolution_clock::now();
+    std::cout << "\nЗмейка " << size << "x" << size << ": комнат " << roomCount
+        << ", площадь " << maxArea << ", разметка "
+        << std::chrono::duration_cast<std::chrono::milliseconds>(snakeEnd - snakeStart).count()
+        << " мс" << std::endl;
+
     return 0;
 }
@@ -12,14 +12,25 @@ private:
   int cols;
   std::vector<std::vector<int>>
   walls; // 0 - нет стены, битовая маска для сторон
-  std::vector<std::vector<bool>> visited;
+  std::vector<int> roomIds;   // Номер комнаты клетки (x, y) в x * cols + y
+  std::vector<int> roomSizes; // Площадь комнаты по её номеру
+
+  // Корень множества клетки со сжатием пути половинным делением
+  int findRoot(int cell)
+  {
+    while (roomIds[cell] != cell)
+    {
+      roomIds[cell] = roomIds[roomIds[cell]];
+      cell = roomIds[cell];
+    }
+    return cell;
+  }
 
 public:
   Castle(int m, int n) : rows(m), cols(n)
   {
     walls.resize(rows, std::vector<int>(cols, 0)); // Инициализируем стены
-    visited.resize(rows,
-                   std::vector<bool>(cols, false)); // Массив посещённых клеток
+    roomIds.resize(static_cast<size_t>(rows) * cols);
   }
 
   void setWall(int x, int y, Direction dir)
@@ -48,53 +59,66 @@ public:
 
   bool hasWall(int x, int y, Direction dir) { return walls[x][y] & (1 << dir); }
 
-  int countArea(int x, int y)
+  // Разметка комнат без рекурсии: первый проход объединяет клетку с
+  // верхней и левой соседкой, корнем становится меньший номер клетки, и
+  // второй проход в том же порядке раздаёт комнатам номера по порядку
+  void labelRooms()
   {
-    if (x < 0 || x >= rows || y < 0 || y >= cols || visited[x][y])
+    for (int i = 0; i < rows; ++i)
     {
-      return 0;
+      for (int j = 0; j < cols; ++j)
+      {
+        int cell = i * cols + j;
+        int root = cell;
+        if (i > 0 && !hasWall(i, j, NORTH))
+        {
+          root = findRoot(cell - cols);
+        }
+        if (j > 0 && !hasWall(i, j, WEST))
+        {
+          int left = findRoot(cell - 1);
+          if (left < root)
+          {
+            if (root != cell)
+            {
+              roomIds[root] = left;
+            }
+            root = left;
+          }
+          else if (left > root)
+          {
+            roomIds[left] = root;
+          }
+        }
+        roomIds[cell] = root;
+      }
     }
 
-    visited[x][y] = true;
-    int area = 1;
-
-    // Проверяем соседей
-    if (!hasWall(x, y, NORTH))
+    roomSizes.clear();
+    for (int cell = 0; cell < rows * cols; ++cell)
     {
-      area += countArea(x - 1, y);
-    }
-    if (!hasWall(x, y, SOUTH))
-    {
-      area += countArea(x + 1, y);
-    }
-    if (!hasWall(x, y, EAST))
-    {
-      area += countArea(x, y + 1);
-    }
-    if (!hasWall(x, y, WEST))
-    {
-      area += countArea(x, y - 1);
+      int parent = roomIds[cell];
+      if (parent == cell)
+      {
+        roomIds[cell] = static_cast<int>(roomSizes.size());
+        roomSizes.push_back(0);
+      }
+      else
+      {
+        roomIds[cell] = roomIds[parent];
+      }
+      roomSizes[roomIds[cell]]++;
     }
-
-    return area;
   }
 
   void findRooms(int& roomCount, int& maxArea)
   {
-    visited.assign(rows, std::vector<bool>(cols, false));
-    roomCount = 0;
+    labelRooms();
+    roomCount = static_cast<int>(roomSizes.size());
     maxArea = 0;
-
-    for (int i = 0; i < rows; ++i)
+    for (int area : roomSizes)
     {
-      for (int j = 0; j < cols; ++j)
-      {
-        if (!visited[i][j])
-        {
-          roomCount++;
-          maxArea = std::max(maxArea, countArea(i, j));
-        }
-      }
+      maxArea = std::max(maxArea, area);
     }
   }
 
@@ -120,13 +144,9 @@ public:
             walls[i][j] ^= (1 << dir);
             walls[nx][ny] ^= (1 << ((dir + 2) % 4));
 
-            visited.assign(rows, std::vector<bool>(cols, false));
-            int area1 = countArea(i, j);
-
-            visited.assign(rows, std::vector<bool>(cols, false));
-            int area2 = countArea(nx, ny);
-
-            int combinedArea = area1 + area2;
+            // Размечаем замок заново: обе клетки теперь в одной комнате
+            labelRooms();
+            int combinedArea = roomSizes[roomIds[i * cols + j]];
 
             if (combinedArea > maxCombinedArea)
             {